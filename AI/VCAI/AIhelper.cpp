@@ -26,6 +26,7 @@ AIhelper::~AIhelper()
 
 bool AIhelper::notifyGoalCompleted(Goals::TSubgoal goal)
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->notifyGoalCompleted(goal);
 }
 
@@ -45,81 +46,97 @@ void AIhelper::setAI(VCAI * AI)
 
 bool AIhelper::getBuildingOptions(const CGTownInstance * t)
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return buildingManager->getBuildingOptions(t);
 }
 
 BuildingID AIhelper::getMaxPossibleGoldBuilding(const CGTownInstance * t)
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return buildingManager->getMaxPossibleGoldBuilding(t);
 }
 
 boost::optional<PotentialBuilding> AIhelper::immediateBuilding() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return buildingManager->immediateBuilding();
 }
 
 boost::optional<PotentialBuilding> AIhelper::expensiveBuilding() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return buildingManager->expensiveBuilding();
 }
 
 boost::optional<BuildingID> AIhelper::canBuildAnyStructure(const CGTownInstance * t, const std::vector<BuildingID> & buildList, unsigned int maxDays) const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return buildingManager->canBuildAnyStructure(t, buildList, maxDays);
 }
 
 Goals::TSubgoal AIhelper::whatToDo(TResources & res, Goals::TSubgoal goal)
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->whatToDo(res, goal);
 }
 
 Goals::TSubgoal AIhelper::whatToDo() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->whatToDo();
 }
 
 bool AIhelper::containsObjective(Goals::TSubgoal goal) const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->containsObjective(goal);
 }
 
 bool AIhelper::hasTasksLeft() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->hasTasksLeft();
 }
 
 bool AIhelper::removeOutdatedObjectives(std::function<bool(const Goals::TSubgoal&)> predicate)
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->removeOutdatedObjectives(predicate);
 }
 
 bool AIhelper::canAfford(const TResources & cost) const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->canAfford(cost);
 }
 
 TResources AIhelper::reservedResources() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->reservedResources();
 }
 
 TResources AIhelper::freeResources() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->freeResources();
 }
 
 TResource AIhelper::freeGold() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->freeGold();
 }
 
 TResources AIhelper::allResources() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->allResources();
 }
 
 TResource AIhelper::allGold() const
 {
+	boost::unique_lock<boost::recursive_mutex> lock(managersMutex);
 	return resourceManager->allGold();
 }
 
@@ -152,3 +169,13 @@ void AIhelper::resetPaths()
 {
 	pathfindingManager->resetPaths();
 }
+
+void AIhelper::invalidatePaths(const int3 & tile)
+{
+	pathfindingManager->invalidatePaths(tile);
+}
+
+void AIhelper::invalidatePaths(const CGObjectInstance * obj)
+{
+	pathfindingManager->invalidatePaths(obj);
+}
@@ -32,6 +32,9 @@ class DLL_EXPORT AIhelper : public IResourceManager, public IBuildingManager, pu
 	std::shared_ptr<BuildingManager> buildingManager;
 	std::shared_ptr<PathfindingManager> pathfindingManager;
 	//TODO: vector<IAbstractManager>
+
+	//resource and building managers are not thread-safe, goals may be decomposed in parallel
+	mutable boost::recursive_mutex managersMutex;
 public:
 	AIhelper();
 	~AIhelper();
@@ -61,6 +64,8 @@ public:
 	Goals::TGoalVec howToVisitObj(ObjectIdRef obj) override;
 	std::vector<AIPath> getPathsToTile(HeroPtr hero, int3 tile) override;
 	void resetPaths() override;
+	void invalidatePaths(const int3 & tile) override;
+	void invalidatePaths(const CGObjectInstance * obj) override;
 
 	STRONG_INLINE
 	bool isTileAccessible(const HeroPtr & hero, const int3 & tile)
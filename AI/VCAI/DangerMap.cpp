@@ -0,0 +1,180 @@
+/*
+* DangerMap.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#include "StdInc.h"
+#include "DangerMap.h"
+#include "AIUtility.h"
+#include "VCAI.h"
+#include "FuzzyHelper.h"
+
+#include "../../lib/mapObjects/CGHeroInstance.h"
+#include "../../lib/mapping/CMapDefines.h"
+
+extern boost::thread_specific_ptr<CCallback> cb;
+extern boost::thread_specific_ptr<VCAI> ai;
+extern boost::thread_specific_ptr<FuzzyHelper> fh;
+
+const ui64 DangerMap::UNKNOWN_DANGER = std::numeric_limits<ui64>::max();
+
+DangerMap::DangerMap()
+	: mapSize(0, 0, 0), changes(0)
+{
+}
+
+size_t DangerMap::getTileIndex(const int3 & tile) const
+{
+	return (tile.z * mapSize.y + tile.y) * mapSize.x + tile.x;
+}
+
+ui64 DangerMap::getDanger(const int3 & tile, const CGHeroInstance * visitor)
+{
+	const ui64 heroStrength = visitor->getTotalStrength();
+	ui64 changesBefore;
+	{
+		boost::unique_lock<boost::mutex> lock(layersMutex);
+
+		auto & layer = layers[visitor];
+		if(layer.danger.empty() || layer.heroStrength != heroStrength)
+		{
+			mapSize = cb->getMapSize();
+			layer.heroStrength = heroStrength;
+			layer.danger.assign(mapSize.x * mapSize.y * mapSize.z, UNKNOWN_DANGER);
+		}
+
+		const ui64 danger = layer.danger[getTileIndex(tile)];
+		if(danger != UNKNOWN_DANGER)
+			return danger;
+
+		changesBefore = changes;
+	}
+
+	// Other threads may query their tiles while the fuzzy engine runs
+	bool behindGate = false;
+	const ui64 danger = calculateDanger(tile, visitor, behindGate);
+
+	boost::unique_lock<boost::mutex> lock(layersMutex);
+
+	auto layer = layers.find(visitor);
+	if(layer != layers.end() && layer->second.heroStrength == heroStrength && changes == changesBefore)
+	{
+		layer->second.danger[getTileIndex(tile)] = danger;
+		if(behindGate)
+			gateTiles.insert(tile);
+	}
+
+	return danger;
+}
+
+void DangerMap::reset()
+{
+	boost::unique_lock<boost::mutex> lock(layersMutex);
+
+	layers.clear();
+	gateTiles.clear();
+	changes++;
+}
+
+void DangerMap::invalidateTile(const int3 & tile)
+{
+	for(auto & layer : layers)
+		layer.second.danger[getTileIndex(tile)] = UNKNOWN_DANGER;
+}
+
+void DangerMap::invalidateAround(const int3 & tile)
+{
+	boost::unique_lock<boost::mutex> lock(layersMutex);
+
+	if(layers.empty())
+		return;
+
+	changes++;
+
+	// Danger of a tile depends on objects at the tile and guards around it
+	for(int3 pos = tile - int3(1, 1, 0); pos.x <= tile.x + 1; pos.x++)
+	{
+		for(pos.y = tile.y - 1; pos.y <= tile.y + 1; pos.y++)
+		{
+			if(cb->isInTheMap(pos))
+				invalidateTile(pos);
+		}
+	}
+
+	for(auto & gateTile : gateTiles)
+		invalidateTile(gateTile);
+	gateTiles.clear();
+}
+
+void DangerMap::invalidateAround(const CGObjectInstance * obj)
+{
+	for(int fx = 0; fx < obj->getWidth(); ++fx)
+	{
+		for(int fy = 0; fy < obj->getHeight(); ++fy)
+		{
+			invalidateAround(obj->pos - int3(fx, fy, 0));
+		}
+	}
+}
+
+ui64 DangerMap::calculateDanger(const int3 & tile, const CGHeroInstance * visitor, bool & behindGate) const
+{
+	const TerrainTile * t = cb->getTile(tile, false);
+	if(!t) //we can know about guard but can't check its tile (the edge of fow)
+		return 190000000; //MUCH
+
+	ui64 objectDanger = 0;
+	ui64 guardDanger = 0;
+
+	auto visitableObjects = cb->getVisitableObjs(tile);
+	// in some scenarios hero happens to be "under" the object (eg town). Then we consider ONLY the hero.
+	if(vstd::contains_if(visitableObjects, objWithID<Obj::HERO>))
+	{
+		vstd::erase_if(visitableObjects, [](const CGObjectInstance * obj)
+		{
+			return !objWithID<Obj::HERO>(obj);
+		});
+	}
+
+	if(const CGObjectInstance * dangerousObject = vstd::backOrNull(visitableObjects))
+	{
+		objectDanger = evaluateDanger(dangerousObject); //unguarded objects can also be dangerous or unhandled
+		if(objectDanger)
+		{
+			//TODO: don't downcast objects AI shouldn't know about!
+			auto armedObj = dynamic_cast<const CArmedInstance *>(dangerousObject);
+			if(armedObj)
+			{
+				float tacticalAdvantage = fh->tacticalAdvantageEngine.getTacticalAdvantage(visitor, armedObj);
+				objectDanger *= tacticalAdvantage; //this line tends to go infinite for allied towns (?)
+			}
+		}
+		if(dangerousObject->ID == Obj::SUBTERRANEAN_GATE)
+		{
+			//check guard on the other side of the gate
+			auto it = ai->knownSubterraneanGates.find(dangerousObject);
+			if(it != ai->knownSubterraneanGates.end())
+			{
+				behindGate = true;
+				auto guards = cb->getGuardingCreatures(it->second->visitablePos());
+				for(auto cre : guards)
+				{
+					vstd::amax(guardDanger, evaluateDanger(cre) * fh->tacticalAdvantageEngine.getTacticalAdvantage(visitor, dynamic_cast<const CArmedInstance *>(cre)));
+				}
+			}
+		}
+	}
+
+	auto guards = cb->getGuardingCreatures(tile);
+	for(auto cre : guards)
+	{
+		vstd::amax(guardDanger, evaluateDanger(cre) * fh->tacticalAdvantageEngine.getTacticalAdvantage(visitor, dynamic_cast<const CArmedInstance *>(cre))); //we are interested in strongest monster around
+	}
+
+	//TODO mozna odwiedzic blockvis nie ruszajac straznika
+	return std::max(objectDanger, guardDanger);
+}
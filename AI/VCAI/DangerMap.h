@@ -0,0 +1,53 @@
+/*
+* DangerMap.h, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#pragma once
+
+#include "../../lib/int3.h"
+
+class CGHeroInstance;
+class CGObjectInstance;
+
+/// Danger of map tiles for each hero, evaluated once per turn on first use.
+/// A hero layer is dropped when the strength of the hero changes, tiles are
+/// invalidated around objects and heroes which changed since the evaluation.
+class DangerMap
+{
+private:
+	struct HeroLayer
+	{
+		ui64 heroStrength;
+		std::vector<ui64> danger; //UNKNOWN_DANGER if not evaluated yet
+	};
+
+	static const ui64 UNKNOWN_DANGER;
+
+	std::map<const CGHeroInstance *, HeroLayer> layers;
+	/// Tiles whose danger depends on guards at the other side of a subterranean gate
+	std::set<int3> gateTiles;
+	int3 mapSize;
+	/// Incremented by every reset and invalidation, dangers evaluated before a change are not stored
+	ui64 changes;
+	boost::mutex layersMutex;
+
+	size_t getTileIndex(const int3 & tile) const;
+	ui64 calculateDanger(const int3 & tile, const CGHeroInstance * visitor, bool & behindGate) const;
+	void invalidateTile(const int3 & tile);
+
+public:
+	DangerMap();
+
+	ui64 getDanger(const int3 & tile, const CGHeroInstance * visitor);
+
+	/// Drops all layers, to be called at the start of each turn
+	void reset();
+	/// Invalidates tiles whose danger may depend on the given tile
+	void invalidateAround(const int3 & tile);
+	void invalidateAround(const CGObjectInstance * obj);
+};
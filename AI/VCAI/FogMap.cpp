@@ -0,0 +1,216 @@
+/*
+* FogMap.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#include "StdInc.h"
+#include "FogMap.h"
+#include "VCAI.h"
+
+#include "../../lib/CPlayerState.h"
+
+extern boost::thread_specific_ptr<CCallback> cb;
+extern boost::thread_specific_ptr<VCAI> ai;
+
+FogMap::FogMap()
+	: mapSize(0, 0, 0), sumsValid(false)
+{
+}
+
+bool FogMap::ScanOrder::operator()(const int3 & lhs, const int3 & rhs) const
+{
+	return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z);
+}
+
+const FogMap::FoW & FogMap::getFoW() const
+{
+	return cb->getPlayerTeam(ai->playerID)->fogOfWarMap;
+}
+
+int3 FogMap::getMapSize() const
+{
+	return cb->getMapSize();
+}
+
+bool FogMap::isInTheMap(const int3 & tile) const
+{
+	return tile.x >= 0 && tile.y >= 0 && tile.z >= 0
+		&& tile.x < mapSize.x && tile.y < mapSize.y && tile.z < mapSize.z;
+}
+
+void FogMap::reset()
+{
+	boost::unique_lock<boost::mutex> lock(fogMutex);
+
+	mapSize = int3(0, 0, 0);
+	frontier.clear();
+	sumsValid = false;
+}
+
+void FogMap::initialize()
+{
+	if(mapSize.z)
+		return;
+
+	const FoW & fow = getFoW();
+
+	mapSize = getMapSize();
+	sumsValid = false;
+
+	for(int x = 0; x < mapSize.x; x++)
+	{
+		for(int y = 0; y < mapSize.y; y++)
+		{
+			for(int z = 0; z < mapSize.z; z++)
+				updateFrontier(fow, int3(x, y, z));
+		}
+	}
+}
+
+void FogMap::updateFrontier(const FoW & fow, const int3 & tile)
+{
+	bool hasHiddenNeighbour = false;
+
+	if(fow[tile.x][tile.y][tile.z])
+	{
+		for(const int3 & dir : int3::getDirs())
+		{
+			const int3 neighbour = tile + dir;
+			if(isInTheMap(neighbour) && !fow[neighbour.x][neighbour.y][neighbour.z])
+				hasHiddenNeighbour = true;
+		}
+	}
+
+	if(hasHiddenNeighbour)
+		frontier.insert(tile);
+	else
+		frontier.erase(tile);
+}
+
+void FogMap::update(const std::unordered_set<int3, ShashInt3> & tiles)
+{
+	boost::unique_lock<boost::mutex> lock(fogMutex);
+
+	if(!mapSize.z)
+		return; //not used yet
+
+	const FoW & fow = getFoW();
+
+	for(const int3 & tile : tiles)
+	{
+		updateFrontier(fow, tile);
+
+		for(const int3 & dir : int3::getDirs())
+		{
+			const int3 neighbour = tile + dir;
+			if(isInTheMap(neighbour))
+				updateFrontier(fow, neighbour);
+		}
+	}
+
+	//a single tile changes sums of the whole quarter of the map, recalculate it once on next query
+	sumsValid = false;
+}
+
+void FogMap::calculateSums()
+{
+	const FoW & fow = getFoW();
+
+	hiddenSums.resize(boost::extents[mapSize.z][mapSize.y + 1][mapSize.x + 1]);
+
+	for(int z = 0; z < mapSize.z; z++)
+	{
+		for(int x = 0; x <= mapSize.x; x++)
+			hiddenSums[z][0][x] = 0;
+
+		for(int y = 0; y < mapSize.y; y++)
+		{
+			int rowSum = 0;
+
+			hiddenSums[z][y + 1][0] = 0;
+
+			for(int x = 0; x < mapSize.x; x++)
+			{
+				if(!fow[x][y][z])
+					rowSum++;
+
+				hiddenSums[z][y + 1][x + 1] = hiddenSums[z][y][x + 1] + rowSum;
+			}
+		}
+	}
+
+	sumsValid = true;
+}
+
+void FogMap::prepareSums()
+{
+	initialize();
+
+	if(!sumsValid)
+		calculateSums();
+}
+
+int FogMap::countHiddenTiles(int z, int x1, int y1, int x2, int y2) const
+{
+	vstd::amax(x1, 0);
+	vstd::amax(y1, 0);
+	vstd::amin(x2, mapSize.x - 1);
+	vstd::amin(y2, mapSize.y - 1);
+
+	if(x1 > x2 || y1 > y2)
+		return 0;
+
+	return hiddenSums[z][y2 + 1][x2 + 1]
+		- hiddenSums[z][y1][x2 + 1]
+		- hiddenSums[z][y2 + 1][x1]
+		+ hiddenSums[z][y1][x1];
+}
+
+std::vector<int3> FogMap::getFrontier()
+{
+	boost::unique_lock<boost::mutex> lock(fogMutex);
+
+	initialize();
+
+	return std::vector<int3>(frontier.begin(), frontier.end());
+}
+
+int FogMap::countHiddenTilesInSquare(const int3 & center, int radius)
+{
+	boost::unique_lock<boost::mutex> lock(fogMutex);
+
+	prepareSums();
+
+	return countHiddenTiles(center.z, center.x - radius, center.y - radius, center.x + radius, center.y + radius);
+}
+
+int FogMap::countHiddenTilesInSight(const int3 & center, int radius)
+{
+	boost::unique_lock<boost::mutex> lock(fogMutex);
+
+	prepareSums();
+
+	// tiles with dist2d - 0.5 < radius, i.e. dx^2 + dy^2 <= radius^2 + radius
+	const int maxDistSq = radius * radius + radius;
+	int result = 0;
+
+	for(int dy = -radius; dy <= radius; dy++)
+	{
+		int limit = maxDistSq - dy * dy;
+		int dx = static_cast<int>(std::sqrt(limit));
+
+		while(dx * dx > limit)
+			dx--;
+
+		while((dx + 1) * (dx + 1) <= limit)
+			dx++;
+
+		result += countHiddenTiles(center.z, center.x - dx, center.y + dy, center.x + dx, center.y + dy);
+	}
+
+	return result;
+}
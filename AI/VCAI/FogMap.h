@@ -0,0 +1,65 @@
+/*
+* FogMap.h, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#pragma once
+
+#include "../../lib/int3.h"
+
+/// Fog of war of the AI team prepared for exploration queries.
+/// Keeps visible tiles which border hidden ones and a summed-area table of hidden tiles,
+/// built on first use and updated when tiles are revealed or hidden.
+class FogMap
+{
+public:
+	typedef boost::multi_array<ui8, 3> FoW;
+
+private:
+	/// Orders tiles by x, y and then level like foreach_tile_pos, so exploration chooses
+	/// among equally good tiles the same one as a scan of the whole map
+	struct ScanOrder
+	{
+		bool operator()(const int3 & lhs, const int3 & rhs) const;
+	};
+
+	int3 mapSize;
+	/// Visible tiles with at least one hidden neighbour
+	std::set<int3, ScanOrder> frontier;
+	/// [z][y][x] - number of hidden tiles in rectangle (0, 0) - (x - 1, y - 1) of the level
+	boost::multi_array<int, 3> hiddenSums;
+	bool sumsValid;
+	boost::mutex fogMutex;
+
+	void initialize();
+	bool isInTheMap(const int3 & tile) const;
+	void updateFrontier(const FoW & fow, const int3 & tile);
+	void calculateSums();
+	int countHiddenTiles(int z, int x1, int y1, int x2, int y2) const;
+	void prepareSums();
+
+protected:
+	/// [x][y][z] - tile is visible to the team of the AI
+	virtual const FoW & getFoW() const;
+	virtual int3 getMapSize() const;
+
+public:
+	FogMap();
+	virtual ~FogMap() = default;
+
+	/// Drops all data, the map is prepared again on next query
+	void reset();
+	/// Updates the map after visibility of given tiles has changed
+	void update(const std::unordered_set<int3, ShashInt3> & tiles);
+
+	/// Tiles in order of foreach_tile_pos
+	std::vector<int3> getFrontier();
+	/// Number of hidden tiles in the square of given radius around the tile
+	int countHiddenTilesInSquare(const int3 & center, int radius);
+	/// Number of hidden tiles which will be revealed by a hero with given sight radius standing at the tile
+	int countHiddenTilesInSight(const int3 & center, int radius);
+};
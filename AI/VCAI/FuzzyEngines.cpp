@@ -12,6 +12,7 @@
 #include "Goals/Goals.h"
 
 #include "../../lib/mapObjects/MapObjects.h"
+#include "../../lib/CConfigHandler.h"
 #include "VCAI.h"
 #include "MapObjectsEvaluator.h"
 
@@ -20,6 +21,179 @@
 
 extern boost::thread_specific_ptr<VCAI> ai;
 
+FuzzyResponseTable TacticalAdvantageEngine::responseTable;
+FuzzyResponseTable VisitTileEngine::responseTable;
+FuzzyResponseTable VisitObjEngine::responseTable;
+
+static fl::scalar processEngine(fl::Engine & engine, fl::OutputVariable * output, const std::vector<FuzzyResponseTable::Axis> & axes, const fl::scalar * inputs)
+{
+	for(size_t i = 0; i < axes.size(); i++)
+		axes[i].variable->setValue(inputs[i]);
+
+	engine.process();
+	return output->getValue();
+}
+
+FuzzyResponseTable::FuzzyResponseTable()
+	: built(false), valid(false)
+{
+}
+
+void FuzzyResponseTable::build(const std::string & name, fl::Engine & engine, fl::OutputVariable * output, const std::vector<Axis> & axes, int resolution, fl::scalar maxError, size_t maxSize)
+{
+	boost::unique_lock<boost::mutex> lock(buildMutex);
+
+	if(built)
+		return;
+	built = true;
+
+	assert(axes.size() <= MAX_AXES);
+	vstd::amax(resolution, 2);
+
+	size_t size = 1;
+	grids.resize(axes.size());
+	for(size_t i = 0; i < axes.size(); i++)
+	{
+		const fl::scalar range = axes[i].variable->getMaximum() - axes[i].variable->getMinimum();
+		Grid & grid = grids[i];
+
+		grid.minimum = axes[i].variable->getMinimum();
+		if(axes[i].discrete)
+			grid.points = static_cast<int>(std::round(range)) + 1;
+		else
+			grid.points = axes[i].points ? axes[i].points : resolution;
+		grid.step = grid.points > 1 ? range / (grid.points - 1) : 0;
+		grid.stride = size;
+		size *= grid.points;
+	}
+
+	if(size > maxSize)
+	{
+		logAi->info("Fuzzy response table of %s needs %d values, limit is %d. Using inference instead.", name, size, maxSize);
+		return;
+	}
+
+	try
+	{
+		values.resize(size);
+
+		fl::scalar inputs[MAX_AXES];
+		for(size_t index = 0; index < size; index++)
+		{
+			for(size_t i = 0; i < grids.size(); i++)
+				inputs[i] = grids[i].minimum + grids[i].step * ((index / grids[i].stride) % grids[i].points);
+
+			values[index] = processEngine(engine, output, axes, inputs);
+		}
+
+		const fl::scalar error = validate(engine, output, axes);
+		const fl::scalar allowedError = maxError * (output->getMaximum() - output->getMinimum());
+
+		valid = error <= allowedError;
+		logAi->info("Fuzzy response table of %s: %d values, max error %f, allowed %f%s", name, size, error, allowedError, valid ? "" : ". Using inference instead.");
+	}
+	catch(fl::Exception & fe)
+	{
+		logAi->error("FuzzyResponseTable::build %s: %s", name, fe.getWhat());
+	}
+
+	if(!valid)
+		values.clear();
+}
+
+fl::scalar FuzzyResponseTable::validate(fl::Engine & engine, fl::OutputVariable * output, const std::vector<Axis> & axes) const
+{
+	static const int VALIDATION_SAMPLES = 1000;
+
+	//grid points which are not evaluated correctly (NaN) would spoil whole cells
+	for(float value : values)
+	{
+		if(std::isnan(value))
+			return std::numeric_limits<fl::scalar>::infinity();
+	}
+
+	std::minstd_rand generator; //fixed seed, result of validation should not change between runs
+	fl::scalar maxError = 0;
+	fl::scalar inputs[MAX_AXES];
+
+	for(int sample = 0; sample < VALIDATION_SAMPLES; sample++)
+	{
+		for(size_t i = 0; i < grids.size(); i++)
+		{
+			const fl::scalar minimum = axes[i].variable->getMinimum();
+			const fl::scalar maximum = axes[i].variable->getMaximum();
+
+			if(axes[i].discrete)
+				inputs[i] = minimum + generator() % grids[i].points;
+			else
+				inputs[i] = std::uniform_real_distribution<fl::scalar>(minimum, maximum)(generator);
+		}
+
+		const fl::scalar error = std::abs(processEngine(engine, output, axes, inputs) - evaluate(inputs));
+		if(!(error <= maxError)) //NaN is also an error
+			maxError = std::isnan(error) ? std::numeric_limits<fl::scalar>::infinity() : error;
+	}
+
+	return maxError;
+}
+
+bool FuzzyResponseTable::isValid() const
+{
+	return valid;
+}
+
+fl::scalar FuzzyResponseTable::evaluate(const fl::scalar * inputs) const
+{
+	size_t base = 0;
+	size_t strides[MAX_AXES];
+	fl::scalar fractions[MAX_AXES];
+	size_t interpolated = 0;
+
+	for(size_t i = 0; i < grids.size(); i++)
+	{
+		const Grid & grid = grids[i];
+		if(grid.points == 1)
+			continue;
+
+		fl::scalar position = (inputs[i] - grid.minimum) / grid.step;
+		vstd::abetween(position, 0, grid.points - 1);
+
+		const int cell = std::min(static_cast<int>(position), grid.points - 2);
+		const fl::scalar fraction = position - cell;
+
+		base += cell * grid.stride;
+		if(fraction > 0)
+		{
+			strides[interpolated] = grid.stride;
+			fractions[interpolated] = fraction;
+			interpolated++;
+		}
+	}
+
+	//multilinear interpolation between corners of the cell, axes with input exactly on grid point are skipped
+	fl::scalar result = 0;
+	for(size_t corner = 0; corner < (size_t(1) << interpolated); corner++)
+	{
+		fl::scalar weight = 1;
+		size_t index = base;
+		for(size_t i = 0; i < interpolated; i++)
+		{
+			if(corner & (size_t(1) << i))
+			{
+				weight *= fractions[i];
+				index += strides[i];
+			}
+			else
+			{
+				weight *= 1 - fractions[i];
+			}
+		}
+		result += weight * values[index];
+	}
+
+	return result;
+}
+
 engineBase::engineBase()
 {
 	engine.addRuleBlock(&rules);
@@ -36,6 +210,39 @@ void engineBase::addRule(const std::string & txt)
 	rules.addRule(fl::Rule::parse(txt, &engine));
 }
 
+void engineBase::initResponseTable(FuzzyResponseTable & table, const std::string & name, fl::OutputVariable * output, const std::vector<FuzzyResponseTable::Axis> & axes)
+{
+	const JsonNode & config = settings["ai"]["fuzzyTables"];
+	if(!config["enabled"].Bool())
+		return;
+
+	tableInputs.clear();
+	for(auto & axis : axes)
+		tableInputs.push_back(axis.variable);
+
+	table.build(name, engine, output, axes, config["resolution"].Float(), config["maxError"].Float(), config["maxSize"].Float());
+}
+
+fl::scalar engineBase::process(fl::OutputVariable * output, const FuzzyResponseTable & table)
+{
+	if(table.isValid())
+	{
+		fl::scalar inputs[FuzzyResponseTable::MAX_AXES];
+		bool known = true;
+		for(size_t i = 0; i < tableInputs.size(); i++)
+		{
+			inputs[i] = tableInputs[i]->getValue();
+			known &= !std::isnan(inputs[i]);
+		}
+
+		if(known)
+			return table.evaluate(inputs);
+	}
+
+	engine.process();
+	return output->getValue();
+}
+
 struct armyStructure
 {
 	float walkers, shooters, flyers;
@@ -198,6 +405,15 @@ TacticalAdvantageEngine::TacticalAdvantageEngine()
 		logAi->error("initTacticalAdvantage: %s", pe.getWhat());
 	}
 	configure();
+
+	initResponseTable(responseTable, "TacticalAdvantageEngine", threat,
+	{
+		{ ourWalkers, 0, false }, { ourShooters, 0, false }, { ourFlyers, 0, false },
+		{ enemyWalkers, 0, false }, { enemyShooters, 0, false },
+		{ enemyFlyers, 1, false }, //not used by any rule
+		{ ourSpeed, 0, false }, { enemySpeed, 0, false },
+		{ bankPresent, 0, true }, { castleWalls, 0, true }
+	});
 }
 
 float TacticalAdvantageEngine::getTacticalAdvantage(const CArmedInstance * we, const CArmedInstance * enemy)
@@ -230,8 +446,7 @@ float TacticalAdvantageEngine::getTacticalAdvantage(const CArmedInstance * we, c
 		else
 			castleWalls->setValue(0);
 
-		engine.process();
-		output = threat->getValue();
+		output = process(threat, responseTable);
 	}
 	catch(fl::Exception & fe)
 	{
@@ -383,6 +598,12 @@ VisitObjEngine::VisitObjEngine()
 		logAi->error("FindWanderTarget: %s", fe.getWhat());
 	}
 	configure();
+
+	initResponseTable(responseTable, "VisitObjEngine", value,
+	{
+		{ strengthRatio, 0, false }, { heroStrength, 0, false }, { turnDistance, 0, false },
+		{ missionImportance, 0, false }, { objectValue, 0, false }
+	});
 }
 
 float VisitObjEngine::evaluate(Goals::VisitObj & goal)
@@ -416,8 +637,7 @@ float VisitObjEngine::evaluate(Goals::VisitObj & goal)
 	try
 	{
 		objectValue->setValue(objValue);
-		engine.process();
-		output = value->getValue();
+		output = process(value, responseTable);
 	}
 	catch(fl::Exception & fe)
 	{
@@ -430,6 +650,11 @@ float VisitObjEngine::evaluate(Goals::VisitObj & goal)
 VisitTileEngine::VisitTileEngine() //so far no VisitTile-specific variables that are not shared with HeroMovementGoalEngineBase
 {
 	configure();
+
+	initResponseTable(responseTable, "VisitTileEngine", value,
+	{
+		{ strengthRatio, 0, false }, { heroStrength, 0, false }, { turnDistance, 0, false }, { missionImportance, 0, false }
+	});
 }
 
 float VisitTileEngine::evaluate(Goals::VisitTile & goal)
@@ -444,9 +669,7 @@ float VisitTileEngine::evaluate(Goals::VisitTile & goal)
 
 	try
 	{
-		engine.process();
-
-		goal.priority = value->getValue();
+		goal.priority = process(value, responseTable);
 	}
 	catch(fl::Exception & fe)
 	{
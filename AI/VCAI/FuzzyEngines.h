@@ -13,6 +13,47 @@
 
 class CArmedInstance;
 
+/// Response surface of a fuzzy engine sampled on a regular grid over ranges of its input variables.
+/// Output between grid points is interpolated linearly, which is much cheaper than full inference.
+/// Table is built once per engine type and shared by all engine instances (read-only after build).
+class FuzzyResponseTable
+{
+public:
+	static const size_t MAX_AXES = 10;
+
+	struct Axis
+	{
+		fl::InputVariable * variable;
+		int points; //0 - resolution from settings, 1 - output does not depend on variable
+		bool discrete; //variable takes only integer values from its range, one grid point per value
+	};
+
+	FuzzyResponseTable();
+
+	/// Samples engine output on the grid, does nothing if table was already built.
+	/// Table is used only if interpolated output stays within maxError (fraction of output range) from engine output.
+	void build(const std::string & name, fl::Engine & engine, fl::OutputVariable * output, const std::vector<Axis> & axes, int resolution, fl::scalar maxError, size_t maxSize);
+	bool isValid() const;
+	fl::scalar evaluate(const fl::scalar * inputs) const;
+
+private:
+	struct Grid
+	{
+		fl::scalar minimum;
+		fl::scalar step;
+		int points;
+		size_t stride;
+	};
+
+	std::vector<Grid> grids;
+	std::vector<float> values;
+	bool built;
+	bool valid;
+	boost::mutex buildMutex;
+
+	fl::scalar validate(fl::Engine & engine, fl::OutputVariable * output, const std::vector<Axis> & axes) const;
+};
+
 class engineBase //subclasses create fuzzylite variables with "new" that are not freed - this is desired as fl::Engine wants to destroy these...
 {
 protected:
@@ -20,8 +61,15 @@ protected:
 	fl::RuleBlock rules;
 	virtual void configure();
 	void addRule(const std::string & txt);
+	/// Builds table of this engine type if enabled in settings, inputs are passed to table in order of axes
+	void initResponseTable(FuzzyResponseTable & table, const std::string & name, fl::OutputVariable * output, const std::vector<FuzzyResponseTable::Axis> & axes);
+	/// Runs inference or reads output from response table if it is available
+	fl::scalar process(fl::OutputVariable * output, const FuzzyResponseTable & table);
 public:
 	engineBase();
+
+private:
+	std::vector<fl::InputVariable *> tableInputs;
 };
 
 class TacticalAdvantageEngine : public engineBase
@@ -35,6 +83,8 @@ private:
 	fl::InputVariable * bankPresent;
 	fl::InputVariable * castleWalls;
 	fl::OutputVariable * threat;
+
+	static FuzzyResponseTable responseTable;
 };
 
 class HeroMovementGoalEngineBase : public engineBase //in future - maybe derive from some (GoalEngineBase : public engineBase) class for handling non-movement goals with common utility for goal engines
@@ -60,6 +110,8 @@ class VisitTileEngine : public HeroMovementGoalEngineBase
 public:
 	VisitTileEngine();
 	float evaluate(Goals::VisitTile & goal);
+private:
+	static FuzzyResponseTable responseTable;
 };
 
 class VisitObjEngine : public HeroMovementGoalEngineBase
@@ -69,4 +121,6 @@ public:
 	float evaluate(Goals::VisitObj & goal);
 protected:
 	fl::InputVariable * objectValue;
+private:
+	static FuzzyResponseTable responseTable;
 };
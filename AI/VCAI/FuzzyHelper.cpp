@@ -14,7 +14,7 @@
 #include "Goals/Goals.h"
 #include "VCAI.h"
 
-FuzzyHelper * fh;
+boost::thread_specific_ptr<FuzzyHelper> fh;
 
 extern boost::thread_specific_ptr<VCAI> ai;
 
@@ -35,10 +35,16 @@ Goals::TSubgoal FuzzyHelper::chooseSolution(Goals::TGoalVec vec)
 	};
 	boost::sort(vec, sortByHeroes);
 
+	//evaluation of goals is independent, each worker uses its own fuzzy engines
+	std::vector<std::function<void()>> evaluationTasks;
 	for(auto g : vec)
 	{
-		setPriority(g);
+		evaluationTasks.push_back([g]() mutable
+		{
+			fh->setPriority(g);
+		});
 	}
+	ai->executeTasks(evaluationTasks);
 
 	auto compareGoals = [](const Goals::TSubgoal & lhs, const Goals::TSubgoal & rhs) -> bool
 	{
@@ -23,7 +23,7 @@
 
 extern boost::thread_specific_ptr<CCallback> cb;
 extern boost::thread_specific_ptr<VCAI> ai;
-extern FuzzyHelper * fh;
+extern boost::thread_specific_ptr<FuzzyHelper> fh;
 
 using namespace Goals;
 
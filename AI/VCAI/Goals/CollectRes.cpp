@@ -22,7 +22,7 @@
 
 extern boost::thread_specific_ptr<CCallback> cb;
 extern boost::thread_specific_ptr<VCAI> ai;
-extern FuzzyHelper * fh;
+extern boost::thread_specific_ptr<FuzzyHelper> fh;
 
 using namespace Goals;
 
@@ -96,7 +96,7 @@ TGoalVec CollectRes::getAllPossibleSubgoals()
 	{
 		std::vector<const CGObjectInstance *> ourObjs(objs); //copy common objects
 
-		for (auto obj : ai->reservedHeroesMap[h]) //add objects reserved by this hero
+		for (auto obj : ai->getReservedObjects(h)) //add objects reserved by this hero
 		{
 			if (givesResource(obj))
 				ourObjs.push_back(obj);
@@ -22,7 +22,7 @@
 
 extern boost::thread_specific_ptr<CCallback> cb;
 extern boost::thread_specific_ptr<VCAI> ai;
-extern FuzzyHelper * fh;
+extern boost::thread_specific_ptr<FuzzyHelper> fh;
 
 using namespace Goals;
 
@@ -69,7 +69,7 @@ TGoalVec Conquer::getAllPossibleSubgoals()
 	{
 		std::vector<const CGObjectInstance *> ourObjs(objs); //copy common objects
 
-		for(auto obj : ai->reservedHeroesMap[h]) //add objects reserved by this hero
+		for(auto obj : ai->getReservedObjects(h)) //add objects reserved by this hero
 		{
 			if(conquerable(obj))
 				ourObjs.push_back(obj);
@@ -22,7 +22,7 @@
 
 extern boost::thread_specific_ptr<CCallback> cb;
 extern boost::thread_specific_ptr<VCAI> ai;
-extern FuzzyHelper * fh;
+extern boost::thread_specific_ptr<FuzzyHelper> fh;
 
 using namespace Goals;
 
@@ -73,33 +73,10 @@ namespace Goals
 
 		void scanMap()
 		{
-			int3 mapSize = cbp->getMapSize();
-			int perimeter = 2 * sightRadius * (mapSize.x + mapSize.y);
-
-			std::vector<int3> from;
+			std::vector<int3> from = aip->fogMap.getFrontier();
 			std::vector<int3> to;
 
-			from.reserve(perimeter);
-			to.reserve(perimeter);
-
-			foreach_tile_pos([&](const int3 & pos)
-			{
-				if(ts->fogOfWarMap[pos.x][pos.y][pos.z])
-				{
-					bool hasInvisibleNeighbor = false;
-
-					foreach_neighbour(cbp, pos, [&](CCallback * cbp, int3 neighbour)
-					{
-						if(!ts->fogOfWarMap[neighbour.x][neighbour.y][neighbour.z])
-						{
-							hasInvisibleNeighbor = true;
-						}
-					});
-
-					if(hasInvisibleNeighbor)
-						from.push_back(pos);
-				}
-			});
+			to.reserve(from.size() * sightRadius);
 
 			logAi->debug("Exploration scan visible area perimeter for hero %s", hero.name);
 
@@ -133,7 +110,10 @@ namespace Goals
 		void scanTile(const int3 & tile)
 		{
 			if(tile == ourPos
-				|| !aip->ah->isTileAccessible(hero, tile)) //shouldn't happen, but it does
+				|| !aip->fogMap.countHiddenTilesInSquare(tile, sightRadius)) //quick check before costly path queries
+				return;
+
+			if(!aip->ah->isTileAccessible(hero, tile)) //shouldn't happen, but it does
 				return;
 
 			int tilesDiscovered = howManyTilesWillBeDiscovered(tile);
@@ -185,6 +165,11 @@ namespace Goals
 		int howManyTilesWillBeDiscovered(
 			const int3 & pos) const
 		{
+			int hiddenTiles = aip->fogMap.countHiddenTilesInSight(pos, sightRadius);
+
+			if(!hiddenTiles || !allowDeadEndCancellation)
+				return hiddenTiles;
+
 			int ret = 0;
 			for(int x = pos.x - sightRadius; x <= pos.x + sightRadius; x++)
 			{
@@ -285,8 +270,9 @@ TGoalVec Explore::getAllPossibleSubgoals()
 			case Obj::MONOLITH_TWO_WAY:
 			case Obj::SUBTERRANEAN_GATE:
 				auto tObj = dynamic_cast<const CGTeleport *>(obj);
-				assert(ai->knownTeleportChannels.find(tObj->channel) != ai->knownTeleportChannels.end());
-				if(TeleportChannel::IMPASSABLE != ai->knownTeleportChannels[tObj->channel]->passability)
+				auto channel = ai->getKnownTeleportChannel(tObj->channel);
+				assert(channel);
+				if(channel && TeleportChannel::IMPASSABLE != channel->passability)
 					objs.push_back(obj);
 				break;
 			}
@@ -298,9 +284,10 @@ TGoalVec Explore::getAllPossibleSubgoals()
 			case Obj::MONOLITH_TWO_WAY:
 			case Obj::SUBTERRANEAN_GATE:
 				auto tObj = dynamic_cast<const CGTeleport *>(obj);
-				if(TeleportChannel::IMPASSABLE == ai->knownTeleportChannels[tObj->channel]->passability)
+				auto channel = ai->getKnownTeleportChannel(tObj->channel);
+				if(!channel || TeleportChannel::IMPASSABLE == channel->passability)
 					break;
-				for(auto exit : ai->knownTeleportChannels[tObj->channel]->exits)
+				for(auto exit : channel->exits)
 				{
 					if(!cb->getObj(exit))
 					{ // Always attempt to visit two-way teleports if one of channel exits is not visible
@@ -22,7 +22,7 @@
 
 extern boost::thread_specific_ptr<CCallback> cb;
 extern boost::thread_specific_ptr<VCAI> ai;
-extern FuzzyHelper * fh;
+extern boost::thread_specific_ptr<FuzzyHelper> fh;
 
 using namespace Goals;
 
@@ -64,7 +64,7 @@ TGoalVec GatherArmy::getAllPossibleSubgoals()
 			//grab army from town
 			if(!t->visitingHero && howManyReinforcementsCanGet(hero.get(), t))
 			{
-				if(!vstd::contains(ai->townVisitsThisWeek[hero], t))
+				if(!ai->hasVisitedTownThisWeek(hero, t))
 					vstd::concatenate(ret, waysToVisit);
 			}
 
@@ -124,13 +124,13 @@ TGoalVec GatherArmy::getAllPossibleSubgoals()
 	for(auto h : otherHeroes)
 	{
 		// Go to the other hero if we are faster
-		if(!vstd::contains(ai->visitedHeroes[hero], h))
+		if(!ai->hasVisitedHero(hero, h))
 		{
 			vstd::concatenate(ret, ai->ah->howToVisitObj(hero, h));
 		}
 
 		// Go to the other hero if we are faster
-		if(!vstd::contains(ai->visitedHeroes[h], hero))
+		if(!ai->hasVisitedHero(h, hero))
 		{
 			vstd::concatenate(ret, ai->ah->howToVisitObj(h, hero.get()));
 		}
@@ -19,56 +19,137 @@
 extern boost::thread_specific_ptr<CCallback> cb;
 
 
+AINodeStorage::HeroState::HeroState()
+	: inBoat(false), movement(0), mana(0), level(0), landMovePoints(0), seaMovePoints(0),
+	flying(false), waterWalking(false), armyVersion(0), spells(0), wornArtifacts(0)
+{
+	primarySkills.fill(0);
+}
+
+AINodeStorage::HeroState::HeroState(const CGHeroInstance * hero)
+	: position(hero->getPosition(false)),
+	inBoat(hero->boat),
+	movement(hero->movement),
+	mana(hero->mana),
+	level(hero->level),
+	landMovePoints(hero->maxMovePoints(true)),
+	seaMovePoints(hero->maxMovePoints(false)),
+	flying(hero->hasBonusOfType(Bonus::FLYING_MOVEMENT)),
+	waterWalking(hero->hasBonusOfType(Bonus::WATER_WALKING)),
+	armyVersion(hero->getArmyVersion()),
+	spells(hero->getSpellsInSpellbook().size()),
+	wornArtifacts(hero->artifactsWorn.size())
+{
+	for(int i = 0; i < GameConstants::PRIMARY_SKILLS; i++)
+		primarySkills[i] = hero->getPrimSkillLevel(static_cast<PrimarySkill::PrimarySkill>(i));
+}
+
+bool AINodeStorage::HeroState::operator==(const HeroState & other) const
+{
+	return position == other.position
+		&& inBoat == other.inBoat
+		&& movement == other.movement
+		&& mana == other.mana
+		&& level == other.level
+		&& landMovePoints == other.landMovePoints
+		&& seaMovePoints == other.seaMovePoints
+		&& primarySkills == other.primarySkills
+		&& flying == other.flying
+		&& waterWalking == other.waterWalking
+		&& armyVersion == other.armyVersion
+		&& spells == other.spells
+		&& wornArtifacts == other.wornArtifacts;
+}
+
 AINodeStorage::AINodeStorage(const int3 & Sizes)
-	: sizes(Sizes)
+	: sizes(Sizes), hero(nullptr), usedNodes(0), gs(nullptr), fow(nullptr), useFlying(false), useWaterWalking(false)
 {
-	nodes.resize(boost::extents[sizes.x][sizes.y][sizes.z][EPathfindingLayer::NUM_LAYERS][NUM_CHAINS]);
+	nodeIndex.resize(sizes.x * sizes.y * sizes.z * EPathfindingLayer::NUM_LAYERS, NO_NODES);
+	specialActions.resize(1);
 }
 
 AINodeStorage::~AINodeStorage() = default;
 
 void AINodeStorage::initialize(const PathfinderOptions & options, const CGameState * gs, const CGHeroInstance * hero)
 {
-	//TODO: fix this code duplication with NodeStorage::initialize, problem is to keep `resetTile` inline
+	this->gs = gs;
+	fow = &static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(hero->tempOwner)->fogOfWarMap;
+	player = hero->tempOwner;
+	useFlying = options.useFlying;
+	useWaterWalking = options.useWaterWalking;
+
+	//nodes are reset when they are taken again, so it is enough to forget where they were
+	boost::fill(nodeIndex, NO_NODES);
+	usedNodes = 0;
+	specialActions.resize(1);
+}
+
+size_t AINodeStorage::getIndex(const int3 & tile, EPathfindingLayer layer) const
+{
+	return ((tile.z * sizes.y + tile.y) * sizes.x + tile.x) * EPathfindingLayer::NUM_LAYERS + layer;
+}
+
+CGPathNode::EAccessibility AINodeStorage::evaluateAccessibility(const int3 & pos, EPathfindingLayer layer) const
+{
+	const TerrainTile * tile = &gs->map->getTile(pos);
+
+	switch(tile->terType)
+	{
+	case ETerrainType::ROCK:
+		break;
+
+	case ETerrainType::WATER:
+		if(layer == ELayer::SAIL)
+			return PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, *fow, player, gs);
+		if(layer == ELayer::AIR && useFlying)
+			return PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, *fow, player, gs);
+		if(layer == ELayer::WATER && useWaterWalking)
+			return PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, *fow, player, gs);
+		break;
+
+	default:
+		if(layer == ELayer::LAND)
+			return PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, *fow, player, gs);
+		if(layer == ELayer::AIR && useFlying)
+			return PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, *fow, player, gs);
+		break;
+	}
+
+	return CGPathNode::NOT_SET;
+}
+
+const AINodeStorage::ChainNodes * AINodeStorage::getChains(const int3 & pos, EPathfindingLayer layer) const
+{
+	uint32_t index = nodeIndex[getIndex(pos, layer)];
 
-	int3 pos;
-	const int3 sizes = gs->getMapSize();
-	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(hero->tempOwner)->fogOfWarMap;
-	const PlayerColor player = hero->tempOwner;
+	return index < usedNodes ? &nodes[index] : nullptr;
+}
 
-	//make 200% sure that these are loop invariants (also a bit shorter code), let compiler do the rest(loop unswitching)
-	const bool useFlying = options.useFlying;
-	const bool useWaterWalking = options.useWaterWalking;
+AINodeStorage::ChainNodes * AINodeStorage::getOrCreateChains(const int3 & pos, EPathfindingLayer layer)
+{
+	uint32_t & index = nodeIndex[getIndex(pos, layer)];
 
-	for(pos.x=0; pos.x < sizes.x; ++pos.x)
+	if(index == NO_NODES)
 	{
-		for(pos.y=0; pos.y < sizes.y; ++pos.y)
+		auto accessibility = evaluateAccessibility(pos, layer);
+
+		if(accessibility == CGPathNode::NOT_SET)
 		{
-			for(pos.z=0; pos.z < sizes.z; ++pos.z)
-			{
-				const TerrainTile * tile = &gs->map->getTile(pos);
-				switch(tile->terType)
-				{
-				case ETerrainType::ROCK:
-					break;
-
-				case ETerrainType::WATER:
-					resetTile(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs));
-					if(useFlying)
-						resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
-					if(useWaterWalking)
-						resetTile(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs));
-					break;
-
-				default:
-					resetTile(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs));
-					if(useFlying)
-						resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
-					break;
-				}
-			}
+			index = NO_LAYER;
+		}
+		else
+		{
+			if(usedNodes == nodes.size())
+				nodes.emplace_back();
+
+			index = usedNodes++;
+
+			for(AIPathNode & node : nodes[index])
+				resetNode(node, pos, layer, accessibility);
 		}
 	}
+
+	return index == NO_LAYER ? nullptr : &nodes[index];
 }
 
 const AIPathNode * AINodeStorage::getAINode(const CGPathNode * node) const
@@ -90,9 +171,14 @@ bool AINodeStorage::isBattleNode(const CGPathNode * node) const
 
 boost::optional<AIPathNode *> AINodeStorage::getOrCreateNode(const int3 & pos, const EPathfindingLayer layer, int chainNumber)
 {
-	auto chains = nodes[pos.x][pos.y][pos.z][layer];
+	auto chains = getOrCreateChains(pos, layer);
+
+	if(!chains)
+	{
+		return boost::none;
+	}
 
-	for(AIPathNode & node : chains)
+	for(AIPathNode & node : *chains)
 	{
 		if(node.chainMask == chainNumber)
 		{
@@ -125,18 +211,36 @@ CGPathNode * AINodeStorage::getInitialNode()
 	return initialNode;
 }
 
-void AINodeStorage::resetTile(const int3 & coord, EPathfindingLayer layer, CGPathNode::EAccessibility accessibility)
+void AINodeStorage::resetNode(AIPathNode & node, const int3 & coord, EPathfindingLayer layer, CGPathNode::EAccessibility accessibility)
 {
-	for(int i = 0; i < NUM_CHAINS; i++)
-	{
-		AIPathNode & heroNode = nodes[coord.x][coord.y][coord.z][layer][i];
+	node.reset();
+	node.coord = coord;
+	node.layer = layer;
+	node.accessible = accessibility;
+	node.chainMask = 0;
+	node.danger = 0;
+	node.manaCost = 0;
+	node.specialAction = 0;
+}
 
-		heroNode.chainMask = 0;
-		heroNode.danger = 0;
-		heroNode.manaCost = 0;
-		heroNode.specialAction.reset();
-		heroNode.update(coord, layer, accessibility);
+std::shared_ptr<const ISpecialAction> AINodeStorage::getSpecialAction(const AIPathNode * node) const
+{
+	return specialActions[node->specialAction];
+}
+
+void AINodeStorage::setSpecialAction(AIPathNode * node, std::shared_ptr<const ISpecialAction> action)
+{
+	if(!action)
+	{
+		node->specialAction = 0;
+		return;
 	}
+
+	//the same action is usually assigned to many nodes in a row, like the virtual boat
+	if(specialActions.back() != action)
+		specialActions.push_back(action);
+
+	node->specialAction = specialActions.size() - 1;
 }
 
 void AINodeStorage::commit(CDestinationNodeInfo & destination, const PathNodeInfo & source)
@@ -153,9 +257,9 @@ void AINodeStorage::commit(CDestinationNodeInfo & destination, const PathNodeInf
 		dstNode->theNodeBefore = srcNode->theNodeBefore;
 		dstNode->manaCost = srcNode->manaCost;
 
-		if(dstNode->specialAction)
+		if(auto specialAction = getSpecialAction(dstNode))
 		{
-			dstNode->specialAction->applyOnDestination(getHero(), destination, source, dstNode, srcNode);
+			specialAction->applyOnDestination(getHero(), destination, source, dstNode, srcNode);
 		}
 	});
 }
@@ -189,6 +293,41 @@ std::vector<CGPathNode *> AINodeStorage::calculateNeighbours(
 void AINodeStorage::setHero(HeroPtr heroPtr)
 {
 	hero = heroPtr.get();
+	heroState = HeroState(hero);
+}
+
+bool AINodeStorage::isUpToDate() const
+{
+	return heroState == HeroState(hero);
+}
+
+bool AINodeStorage::isAffectedBy(const int3 & tile) const
+{
+	//danger of a tile depends on guards around it, so neighbours of reached tiles matter as well
+	for(int3 pos = tile - int3(1, 1, 0); pos.x <= tile.x + 1; pos.x++)
+	{
+		for(pos.y = tile.y - 1; pos.y <= tile.y + 1; pos.y++)
+		{
+			if(pos.x < 0 || pos.y < 0 || pos.x >= sizes.x || pos.y >= sizes.y || pos.z < 0 || pos.z >= sizes.z)
+				continue;
+
+			for(EPathfindingLayer layer = EPathfindingLayer::LAND; layer < EPathfindingLayer::NUM_LAYERS; layer.advance(1))
+			{
+				auto chains = getChains(pos, layer);
+
+				if(!chains)
+					continue;
+
+				for(const AIPathNode & node : *chains)
+				{
+					if(node.chainMask && node.reachable())
+						return true;
+				}
+			}
+		}
+	}
+
+	return false;
 }
 
 class TownPortalAction : public ISpecialAction
@@ -299,7 +438,7 @@ void AINodeStorage::calculateTownPortalTeleportations(
 				AIPathNode * node = nodeOptional.get();
 
 				node->theNodeBefore = source.node;
-				node->specialAction.reset(new TownPortalAction(targetTown));
+				setSpecialAction(node, std::make_shared<TownPortalAction>(targetTown));
 				node->moveRemains = source.node->moveRemains;
 				
 				neighbours.push_back(node);
@@ -311,10 +450,15 @@ void AINodeStorage::calculateTownPortalTeleportations(
 bool AINodeStorage::hasBetterChain(const PathNodeInfo & source, CDestinationNodeInfo & destination) const
 {
 	auto pos = destination.coord;
-	auto chains = nodes[pos.x][pos.y][pos.z][EPathfindingLayer::LAND];
+	auto chains = getChains(pos, EPathfindingLayer::LAND);
 	auto destinationNode = getAINode(destination.node);
 
-	for(const AIPathNode & node : chains)
+	if(!chains)
+	{
+		return false;
+	}
+
+	for(const AIPathNode & node : *chains)
 	{
 		auto sameNode = node.chainMask == destinationNode->chainMask;
 		if(sameNode	|| node.action == CGPathNode::ENodeAction::UNKNOWN)
@@ -344,18 +488,23 @@ bool AINodeStorage::hasBetterChain(const PathNodeInfo & source, CDestinationNode
 
 bool AINodeStorage::isTileAccessible(const int3 & pos, const EPathfindingLayer layer) const
 {
-	const AIPathNode & node = nodes[pos.x][pos.y][pos.z][layer][0];
+	auto chains = getChains(pos, layer);
 
-	return node.action != CGPathNode::ENodeAction::UNKNOWN;
+	return chains && chains->front().action != CGPathNode::ENodeAction::UNKNOWN;
 }
 
 std::vector<AIPath> AINodeStorage::getChainInfo(int3 pos, bool isOnLand) const
 {
 	std::vector<AIPath> paths;
-	auto chains = nodes[pos.x][pos.y][pos.z][isOnLand ? EPathfindingLayer::LAND : EPathfindingLayer::SAIL];
+	auto chains = getChains(pos, isOnLand ? EPathfindingLayer::LAND : EPathfindingLayer::SAIL);
 	auto initialPos = hero->visitablePos();
 
-	for(const AIPathNode & node : chains)
+	if(!chains)
+	{
+		return paths;
+	}
+
+	for(const AIPathNode & node : *chains)
 	{
 		if(node.action == CGPathNode::ENodeAction::UNKNOWN)
 		{
@@ -374,7 +523,7 @@ std::vector<AIPath> AINodeStorage::getChainInfo(int3 pos, bool isOnLand) const
 			pathNode.coord = current->coord;
 
 			path.nodes.push_back(pathNode);
-			path.specialAction = current->specialAction;
+			path.specialAction = getSpecialAction(current);
 
 			current = getAINode(current->theNodeBefore);
 		}
@@ -35,9 +35,9 @@ public:
 struct AIPathNode : public CGPathNode
 {
 	uint32_t chainMask;
-	uint64_t danger;
 	uint32_t manaCost;
-	std::shared_ptr<const ISpecialAction> specialAction;
+	uint64_t danger;
+	uint32_t specialAction; //index of the action in node storage, 0 if there is no action
 };
 
 struct AIPathNodeInfo
@@ -68,15 +68,34 @@ struct AIPath
 
 class AINodeStorage : public INodeStorage
 {
+public:
+	/// State of the hero calculated paths depend on, paths have to be recalculated when it changes.
+	/// Movement range, strength and spells of the hero are covered by bonus values and the army version
+	struct HeroState
+	{
+		int3 position;
+		bool inBoat;
+		ui32 movement;
+		si32 mana;
+		ui32 level;
+		int landMovePoints;
+		int seaMovePoints;
+		std::array<int, GameConstants::PRIMARY_SKILLS> primarySkills;
+		bool flying;
+		bool waterWalking;
+		ui32 armyVersion;
+		size_t spells;
+		size_t wornArtifacts;
+
+		HeroState();
+		explicit HeroState(const CGHeroInstance * hero);
+		bool operator==(const HeroState & other) const;
+	};
+
 private:
 	int3 sizes;
-
-	/// 1-3 - position on map, 4 - layer (air, water, land), 5 - chain (normal, battle, spellcast and combinations)
-	boost::multi_array<AIPathNode, 5> nodes;
 	const CGHeroInstance * hero;
-
-	STRONG_INLINE
-	void resetTile(const int3 & tile, EPathfindingLayer layer, CGPathNode::EAccessibility accessibility);
+	HeroState heroState;
 
 public:
 	/// more than 1 chain layer allows us to have more than 1 path to each tile so we can chose more optimal one.
@@ -110,6 +129,9 @@ public:
 	const AIPathNode * getAINode(const CGPathNode * node) const;
 	void updateAINode(CGPathNode * node, std::function<void (AIPathNode *)> updater);
 
+	std::shared_ptr<const ISpecialAction> getSpecialAction(const AIPathNode * node) const;
+	void setSpecialAction(AIPathNode * node, std::shared_ptr<const ISpecialAction> action);
+
 	bool isBattleNode(const CGPathNode * node) const;
 	bool hasBetterChain(const PathNodeInfo & source, CDestinationNodeInfo & destination) const;
 	boost::optional<AIPathNode *> getOrCreateNode(const int3 & coord, const EPathfindingLayer layer, int chainNumber);
@@ -117,6 +139,10 @@ public:
 	bool isTileAccessible(const int3 & pos, const EPathfindingLayer layer) const;
 
 	void setHero(HeroPtr heroPtr);
+	/// Whether hero did not change since paths were calculated
+	bool isUpToDate() const;
+	/// Whether change of the tile may change calculated paths - the tile or some of its neighbours was reached
+	bool isAffectedBy(const int3 & tile) const;
 
 	const CGHeroInstance * getHero() const
 	{
@@ -124,5 +150,34 @@ public:
 	}
 
 private:
+	typedef std::array<AIPathNode, NUM_CHAINS> ChainNodes;
+
+	static const uint32_t NO_NODES = std::numeric_limits<uint32_t>::max(); //nodes of the tile layer are not created yet
+	static const uint32_t NO_LAYER = NO_NODES - 1; //the tile has no such layer
+
+	/// Nodes are created on first access to a tile layer, deque keeps their addresses stable while it grows.
+	/// Nodes are not freed between calculations, only usedNodes is reset.
+	std::deque<ChainNodes> nodes;
+	size_t usedNodes;
+	/// 1-3 - position on map, 4 - layer (air, water, land) -> index in nodes
+	std::vector<uint32_t> nodeIndex;
+	/// Actions referenced by AIPathNode::specialAction, the first one is always empty
+	std::vector<std::shared_ptr<const ISpecialAction>> specialActions;
+
+	// accessibility of tiles is evaluated when their nodes are created
+	const CGameState * gs;
+	const boost::multi_array<ui8, 3> * fow;
+	PlayerColor player;
+	bool useFlying;
+	bool useWaterWalking;
+
+	size_t getIndex(const int3 & tile, EPathfindingLayer layer) const;
+	const ChainNodes * getChains(const int3 & tile, EPathfindingLayer layer) const;
+	ChainNodes * getOrCreateChains(const int3 & tile, EPathfindingLayer layer);
+	CGPathNode::EAccessibility evaluateAccessibility(const int3 & tile, EPathfindingLayer layer) const;
+
+	STRONG_INLINE
+	void resetNode(AIPathNode & node, const int3 & tile, EPathfindingLayer layer, CGPathNode::EAccessibility accessibility);
+
 	void calculateTownPortalTeleportations(const PathNodeInfo & source, std::vector<CGPathNode *> & neighbours);
 };
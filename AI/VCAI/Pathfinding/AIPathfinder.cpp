@@ -12,6 +12,7 @@
 #include "AIPathfinderConfig.h"
 #include "../../../CCallback.h"
 #include "../../../lib/mapping/CMap.h"
+#include "../../../lib/CTurnMetrics.h"
 
 std::vector<std::shared_ptr<AINodeStorage>> AIPathfinder::storagePool;
 std::map<HeroPtr, std::shared_ptr<AINodeStorage>> AIPathfinder::storageMap;
@@ -25,9 +26,31 @@ AIPathfinder::AIPathfinder(CPlayerSpecificInfoCallback * cb, VCAI * ai)
 void AIPathfinder::clear()
 {
 	boost::unique_lock<boost::mutex> storageLock(storageMutex);
+
+	for(auto & storage : storageMap)
+		storagePool.push_back(storage.second);
+
 	storageMap.clear();
 }
 
+void AIPathfinder::invalidateAround(const int3 & tile)
+{
+	boost::unique_lock<boost::mutex> storageLock(storageMutex);
+
+	for(auto it = storageMap.begin(); it != storageMap.end();)
+	{
+		if(it->second->isAffectedBy(tile))
+		{
+			storagePool.push_back(it->second);
+			it = storageMap.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
 void AIPathfinder::init()
 {
 	boost::unique_lock<boost::mutex> storageLock(storageMutex);
@@ -65,32 +88,36 @@ std::shared_ptr<AINodeStorage> AIPathfinder::getOrCreateStorage(const HeroPtr &
 {
 	std::shared_ptr<AINodeStorage> nodeStorage;
 
-	if(!vstd::contains(storageMap, hero))
+	auto it = storageMap.find(hero);
+	if(it != storageMap.end())
 	{
-		logAi->debug("Recalculate paths for %s", hero->name);
+		nodeStorage = it->second;
 
-		if(storageMap.size() < storagePool.size())
-		{
-			nodeStorage = storagePool.at(storageMap.size());
-		}
-		else
-		{
-			nodeStorage = std::make_shared<AINodeStorage>(cb->getMapSize());
-			storagePool.push_back(nodeStorage);
-		}
-
-		storageMap[hero] = nodeStorage;
-		nodeStorage->setHero(hero.get());
-
-		auto config = std::make_shared<AIPathfinding::AIPathfinderConfig>(cb, ai, nodeStorage);
-
-		cb->calculatePaths(config, hero.get());
+		//paths of other heroes are dropped on map changes, changes of the hero itself are detected here
+		if(nodeStorage->isUpToDate())
+			return nodeStorage;
+	}
+	else if(!storagePool.empty())
+	{
+		nodeStorage = storagePool.back();
+		storagePool.pop_back();
 	}
 	else
 	{
-		nodeStorage = storageMap.at(hero);
+		nodeStorage = std::make_shared<AINodeStorage>(cb->getMapSize());
 	}
 
+	logAi->debug("Recalculate paths for %s", hero->name);
+
+	storageMap[hero] = nodeStorage;
+	nodeStorage->setHero(hero.get());
+
+	auto config = std::make_shared<AIPathfinding::AIPathfinderConfig>(cb, ai, nodeStorage);
+
+	auto start = CTurnMetrics::TClock::now();
+	cb->calculatePaths(config, hero.get());
+	turnMetrics.addPathfinding(hero->tempOwner, start);
+
 	return nodeStorage;
 }
 
@@ -17,7 +17,7 @@
 class AIPathfinder
 {
 private:
-	static std::vector<std::shared_ptr<AINodeStorage>> storagePool;
+	static std::vector<std::shared_ptr<AINodeStorage>> storagePool; //storages not used by any hero
 	static std::map<HeroPtr, std::shared_ptr<AINodeStorage>> storageMap;
 	static boost::mutex storageMutex;
 	CPlayerSpecificInfoCallback * cb;
@@ -29,5 +29,7 @@ public:
 	std::vector<AIPath> getPathInfo(HeroPtr hero, int3 tile);
 	bool isTileAccessible(const HeroPtr & hero, const int3 & tile);
 	void clear();
+	/// Drops paths of heroes which may be affected by change of the tile
+	void invalidateAround(const int3 & tile);
 	void init();
 };
@@ -238,7 +238,7 @@ namespace AIPathfinding
 
 					if(boatNode->action == CGPathNode::UNKNOWN)
 					{
-						boatNode->specialAction = virtualBoat;
+						nodeStorage->setSpecialAction(boatNode, virtualBoat);
 						destination.blocked = false;
 						destination.action = CGPathNode::ENodeAction::EMBARK;
 						destination.node = boatNode;
@@ -391,7 +391,7 @@ namespace AIPathfinding
 					battleNode->danger = danger;
 				}
 
-				battleNode->specialAction = std::make_shared<BattleAction>(destination.coord);
+				nodeStorage->setSpecialAction(battleNode, std::make_shared<BattleAction>(destination.coord));
 #ifdef VCMI_TRACE_PATHFINDER
 				logAi->trace(
 					"Begin bypass guard at destination with danger %s while moving %s -> %s",
@@ -430,7 +430,7 @@ namespace AIPathfinding
 
 			if(blocker == BlockingReason::DESTINATION_BLOCKED
 				&& destination.action == CGPathNode::EMBARK
-				&& nodeStorage->getAINode(destination.node)->specialAction)
+				&& nodeStorage->getSpecialAction(nodeStorage->getAINode(destination.node)))
 			{
 				return;
 			}
@@ -482,7 +482,7 @@ namespace AIPathfinding
 
 			auto aiSourceNode = nodeStorage->getAINode(source.node);
 
-			if(aiSourceNode->specialAction)
+			if(nodeStorage->getSpecialAction(aiSourceNode))
 			{
 				// there is some action on source tile which should be performed before we can bypass it
 				destination.node->theNodeBefore = source.node;
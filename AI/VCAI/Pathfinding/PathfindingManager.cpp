@@ -196,7 +196,7 @@ Goals::TSubgoal PathfindingManager::clearWayTo(HeroPtr hero, int3 firstTileToGet
 	if(topObj)
 	{
 
-		if(vstd::contains(ai->reservedObjs, topObj) && !vstd::contains(ai->reservedHeroesMap[hero], topObj))
+		if(ai->isReservedByOtherHero(hero, topObj))
 		{
 			return sptr(Goals::Invalid());
 		}
@@ -240,3 +240,26 @@ void PathfindingManager::resetPaths()
 	logAi->debug("AIPathfinder has been reseted.");
 	pathfinder->clear();
 }
+
+void PathfindingManager::invalidatePaths(const int3 & tile)
+{
+	pathfinder->invalidateAround(tile);
+}
+
+void PathfindingManager::invalidatePaths(const CGObjectInstance * obj)
+{
+	//teleports, town portal targets and boats from shipyards create paths far from the object
+	if(dynamic_cast<const CGTeleport *>(obj) || IShipyard::castFrom(obj))
+	{
+		resetPaths();
+		return;
+	}
+
+	for(int fx = 0; fx < obj->getWidth(); ++fx)
+	{
+		for(int fy = 0; fy < obj->getHeight(); ++fy)
+		{
+			pathfinder->invalidateAround(obj->pos - int3(fx, fy, 0));
+		}
+	}
+}
@@ -21,6 +21,9 @@ public:
 	virtual void setAI(VCAI * AI) = 0;
 
 	virtual void resetPaths() = 0;
+	/// Drops only paths which may depend on the tile or the object
+	virtual void invalidatePaths(const int3 & tile) = 0;
+	virtual void invalidatePaths(const CGObjectInstance * obj) = 0;
 	virtual Goals::TGoalVec howToVisitTile(HeroPtr hero, int3 tile, bool allowGatherArmy = true) = 0;
 	virtual Goals::TGoalVec howToVisitObj(HeroPtr hero, ObjectIdRef obj, bool allowGatherArmy = true) = 0;
 	virtual Goals::TGoalVec howToVisitTile(int3 tile) = 0;
@@ -47,6 +50,8 @@ public:
 	Goals::TGoalVec howToVisitObj(ObjectIdRef obj) override;
 	std::vector<AIPath> getPathsToTile(HeroPtr hero, int3 tile) override;
 	void resetPaths() override;
+	void invalidatePaths(const int3 & tile) override;
+	void invalidatePaths(const CGObjectInstance * obj) override;
 
 	STRONG_INLINE
 	bool isTileAccessible(const HeroPtr & hero, const int3 & tile)
@@ -10,422 +10,325 @@
 
 #include "StdInc.h"
 #include "SectorMap.h"
-#include "VCAI.h"
+#include "AIUtility.h"
 
 #include "../../CCallback.h"
-#include "../../lib/mapping/CMap.h"
-#include "../../lib/mapObjects/MapObjects.h"
-#include "../../lib/CPathfinder.h"
-#include "../../lib/CGameState.h"
+#include "../../lib/mapping/CMapDefines.h"
+#include "../../lib/mapObjects/CObjectHandler.h"
 
 extern boost::thread_specific_ptr<CCallback> cb;
-extern boost::thread_specific_ptr<VCAI> ai;
+
+const SectorMap::TSectorID SectorMap::NOT_AVAILABLE;
 
 SectorMap::SectorMap()
+	: mapSize(0, 0, 0), valid(false), embarkmentPointsValid(false)
 {
-	update();
 }
 
-SectorMap::SectorMap(HeroPtr h)
+size_t SectorMap::getTileIndex(const int3 & tile) const
 {
-	update();
-	makeParentBFS(h->visitablePos());
+	return (tile.z * mapSize.y + tile.y) * mapSize.x + tile.x;
 }
 
-bool SectorMap::markIfBlocked(TSectorID & sec, crint3 pos, const TerrainTile * t)
+int3 SectorMap::getTilePos(size_t index) const
 {
-	if (t->blocked && !t->visitable)
-	{
-		sec = NOT_AVAILABLE;
-		return true;
-	}
-
-	return false;
+	return int3(index % mapSize.x, index / mapSize.x % mapSize.y, index / mapSize.x / mapSize.y);
 }
 
-bool SectorMap::markIfBlocked(TSectorID & sec, crint3 pos)
+bool SectorMap::isInTheMap(const int3 & tile) const
 {
-	return markIfBlocked(sec, pos, getTile(pos));
+	return tile.x >= 0 && tile.y >= 0 && tile.z >= 0
+		&& tile.x < mapSize.x && tile.y < mapSize.y && tile.z < mapSize.z;
 }
 
-void SectorMap::update()
+int3 SectorMap::getMapSize() const
 {
-	visibleTiles = cb->getAllVisibleTiles();
-	auto shape = visibleTiles->shape();
-	sector.resize(boost::extents[shape[0]][shape[1]][shape[2]]);
-
-	clear();
-	int curSector = 3; //0 is invisible, 1 is not explored
+	return cb->getMapSize();
+}
 
-	CCallback * cbp = cb.get(); //optimization
-	foreach_tile_pos([&](crint3 pos)
-	{
-		if (retrieveTile(pos) == NOT_CHECKED)
-		{
-			if (!markIfBlocked(retrieveTile(pos), pos))
-				exploreNewSector(pos, curSector++, cbp);
-		}
-	});
-	valid = true;
+const TerrainTile * SectorMap::getTile(const int3 & tile) const
+{
+	return cb->getTile(tile, false);
 }
 
-SectorMap::TSectorID & SectorMap::retrieveTileN(SectorMap::TSectorArray & a, const int3 & pos)
+bool SectorMap::isObjectOnTheMap(ObjectInstanceID id) const
 {
-	return a[pos.x][pos.y][pos.z];
+	return cb->getObj(id, false) != nullptr;
 }
 
-const SectorMap::TSectorID & SectorMap::retrieveTileN(const SectorMap::TSectorArray & a, const int3 & pos)
+bool SectorMap::isPassable(const TerrainTile * tile) const
 {
-	return a[pos.x][pos.y][pos.z];
+	return !tile->blocked || tile->visitable;
 }
 
-void SectorMap::clear()
+std::vector<int3> SectorMap::getObjectTiles(const CGObjectInstance * obj) const
 {
-	//TODO: rotate to [z][x][y]
-	auto fow = cb->getVisibilityMap();
-	//TODO: any magic to automate this? will need array->array conversion
-	//std::transform(fow.begin(), fow.end(), sector.begin(), [](const ui8 &f) -> unsigned short
-	//{
-	//	return f; //type conversion
-	//});
-	auto width = fow.size();
-	auto height = fow.front().size();
-	auto depth = fow.front().front().size();
-	for (size_t x = 0; x < width; x++)
+	const int3 size = getMapSize();
+	std::vector<int3> tiles;
+
+	for(int fx = 0; fx < obj->getWidth(); ++fx)
 	{
-		for (size_t y = 0; y < height; y++)
+		for(int fy = 0; fy < obj->getHeight(); ++fy)
 		{
-			for (size_t z = 0; z < depth; z++)
-				sector[x][y][z] = fow[x][y][z];
+			int3 tile = obj->pos - int3(fx, fy, 0);
+
+			if(tile.x >= 0 && tile.y >= 0 && tile.x < size.x && tile.y < size.y)
+				tiles.push_back(tile);
 		}
 	}
-	valid = false;
+
+	return tiles;
 }
 
-void SectorMap::exploreNewSector(crint3 pos, int num, CCallback * cbp)
+void SectorMap::forEachNeighbour(const int3 & tile, std::function<void(const int3 &)> foo) const
 {
-	Sector & s = infoOnSectors[num];
-	s.id = num;
-	s.water = getTile(pos)->isWater();
-
-	std::queue<int3> toVisit;
-	toVisit.push(pos);
-	while (!toVisit.empty())
+	for(const int3 & dir : int3::getDirs())
 	{
-		int3 curPos = toVisit.front();
-		toVisit.pop();
-		TSectorID & sec = retrieveTile(curPos);
-		if (sec == NOT_CHECKED)
-		{
-			const TerrainTile * t = getTile(curPos);
-			if (!markIfBlocked(sec, curPos, t))
-			{
-				if (t->isWater() == s.water) //sector is only-water or only-land
-				{
-					sec = num;
-					s.tiles.push_back(curPos);
-					foreach_neighbour(cbp, curPos, [&](CCallback * cbp, crint3 neighPos)
-					{
-						if (retrieveTile(neighPos) == NOT_CHECKED)
-						{
-							toVisit.push(neighPos);
-							//parent[neighPos] = curPos;
-						}
-						const TerrainTile * nt = getTile(neighPos);
-						if (nt && nt->isWater() != s.water && canBeEmbarkmentPoint(nt, s.water))
-						{
-							s.embarkmentPoints.push_back(neighPos);
-						}
-					});
-
-					if (t->visitable)
-					{
-						auto obj = t->visitableObjects.front();
-						if (cb->getObj(obj->id, false)) // FIXME: we have to filter invisible objcts like events, but probably TerrainTile shouldn't be used in SectorMap at all
-							s.visitableObjs.push_back(obj);
-					}
-				}
-			}
-		}
-	}
+		const int3 neighbour = tile + dir;
 
-	vstd::removeDuplicates(s.embarkmentPoints);
+		if(isInTheMap(neighbour))
+			foo(neighbour);
+	}
 }
 
-void SectorMap::write(crstring fname)
+SectorMap::TSectorID SectorMap::find(TSectorID tile)
 {
-	std::ofstream out(fname);
-	for (int k = 0; k < cb->getMapSize().z; k++)
+	while(parent[tile] != tile)
 	{
-		for (int j = 0; j < cb->getMapSize().y; j++)
-		{
-			for (int i = 0; i < cb->getMapSize().x; i++)
-			{
-				out << (int)sector[i][j][k] << '\t';
-			}
-			out << std::endl;
-		}
-		out << std::endl;
+		parent[tile] = parent[parent[tile]]; //path halving
+		tile = parent[tile];
 	}
+
+	return tile;
 }
 
-/*
-this functions returns one target tile or invalid tile. We will use it to poll possible destinations
-For ship construction etc, another function (goal?) is needed
-*/
-int3 SectorMap::firstTileToGet(HeroPtr h, crint3 dst)
+void SectorMap::unite(TSectorID first, TSectorID second)
 {
-	int3 ret(-1, -1, -1);
+	first = find(first);
+	second = find(second);
 
-	int sourceSector = retrieveTile(h->visitablePos());
-	int destinationSector = retrieveTile(dst);
+	if(first == second)
+		return;
 
-	const Sector * src = &infoOnSectors[sourceSector];
-	const Sector * dest = &infoOnSectors[destinationSector];
+	if(rank[first] < rank[second])
+		std::swap(first, second);
 
-	if (sourceSector != destinationSector) //use ships, shipyards etc..
-	{
-		if (ai->isAccessibleForHero(dst, h)) //pathfinder can find a way using ships and gates if tile is not blocked by objects
-			return dst;
+	parent[second] = first;
 
-		std::map<const Sector *, const Sector *> preds;
-		std::queue<const Sector *> sectorQueue;
-		sectorQueue.push(src);
-		while (!sectorQueue.empty())
-		{
-			const Sector * s = sectorQueue.front();
-			sectorQueue.pop();
+	if(rank[first] == rank[second])
+		rank[first]++;
+}
 
-			for (int3 ep : s->embarkmentPoints)
-			{
-				Sector * neigh = &infoOnSectors[retrieveTile(ep)];
-				//preds[s].push_back(neigh);
-				if (!preds[neigh])
-				{
-					preds[neigh] = s;
-					sectorQueue.push(neigh);
-				}
-			}
-		}
+void SectorMap::addTile(const int3 & tile, const TerrainTile * tileInfo)
+{
+	const TSectorID index = getTileIndex(tile);
 
-		if (!preds[dest])
-		{
-			//write("test.txt");
+	parent[index] = index;
+	rank[index] = 0;
+	water[index] = tileInfo->isWater();
 
-			return ret;
-			//throw cannotFulfillGoalException(boost::str(boost::format("Cannot find connection between sectors %d and %d") % src->id % dst->id));
-		}
+	forEachNeighbour(tile, [&](const int3 & neighbour)
+	{
+		const TSectorID neighbourIndex = getTileIndex(neighbour);
 
-		std::vector<const Sector *> toTraverse;
-		toTraverse.push_back(dest);
-		while (toTraverse.back() != src)
-		{
-			toTraverse.push_back(preds[toTraverse.back()]);
-		}
+		//sector is only-water or only-land
+		if(parent[neighbourIndex] != NOT_AVAILABLE && water[neighbourIndex] == water[index])
+			unite(index, neighbourIndex);
+	});
+}
 
-		if (preds[dest])
-		{
-			//TODO: would be nice to find sectors in loop
-			const Sector * sectorToReach = toTraverse.at(toTraverse.size() - 2);
+void SectorMap::build()
+{
+	mapSize = getMapSize();
 
-			if (!src->water && sectorToReach->water) //embark
-			{
-				//embark on ship -> look for an EP with a boat
-				auto firstEP = boost::find_if(src->embarkmentPoints, [=](crint3 pos) -> bool
-				{
-					const TerrainTile * t = getTile(pos);
-					if (t && t->visitableObjects.size() == 1 && t->topVisitableId() == Obj::BOAT)
-					{
-						if (retrieveTile(pos) == sectorToReach->id)
-							return true;
-					}
-					return false;
-				});
-
-				if (firstEP != src->embarkmentPoints.end())
-				{
-					return *firstEP;
-				}
-				else
-				{
-					//we need to find a shipyard with an access to the desired sector's EP
-					//TODO what about Summon Boat spell?
-					std::vector<const IShipyard *> shipyards;
-					for (const CGTownInstance * t : cb->getTownsInfo())
-					{
-						if (t->hasBuilt(BuildingID::SHIPYARD))
-							shipyards.push_back(t);
-					}
-
-					for (const CGObjectInstance * obj : ai->getFlaggedObjects())
-					{
-						if (obj->ID != Obj::TOWN) //towns were handled in the previous loop
-						{
-							if (const IShipyard * shipyard = IShipyard::castFrom(obj))
-								shipyards.push_back(shipyard);
-						}
-					}
-
-					shipyards.erase(boost::remove_if(shipyards, [=](const IShipyard * shipyard) -> bool
-					{
-						return shipyard->shipyardStatus() != 0 || retrieveTile(shipyard->bestLocation()) != sectorToReach->id;
-					}), shipyards.end());
-
-					if (!shipyards.size())
-					{
-						//TODO consider possibility of building shipyard in a town
-						return ret;
-
-						//throw cannotFulfillGoalException("There is no known shipyard!");
-					}
-
-					//we have only shipyards that possibly can build ships onto the appropriate EP
-					auto ownedGoodShipyard = boost::find_if(shipyards, [](const IShipyard * s) -> bool
-					{
-						return s->o->tempOwner == ai->playerID;
-					});
-
-					if (ownedGoodShipyard != shipyards.end())
-					{
-						const IShipyard * s = *ownedGoodShipyard;
-						TResources shipCost;
-						s->getBoatCost(shipCost);
-						if (cb->getResourceAmount().canAfford(shipCost))
-						{
-							int3 ret = s->bestLocation();
-							cb->buildBoat(s); //TODO: move actions elsewhere
-							return ret;
-						}
-						else
-						{
-							//TODO gather res
-							return ret;
-
-							//throw cannotFulfillGoalException("Not enough resources to build a boat");
-						}
-					}
-					else
-					{
-						//TODO pick best shipyard to take over
-						return shipyards.front()->o->visitablePos();
-					}
-				}
-			}
-			else if (src->water && !sectorToReach->water)
-			{
-				//TODO
-				//disembark
-				return ret;
-			}
-			else //use subterranean gates - not needed since gates are now handled via Pathfinder
+	const size_t tilesCount = mapSize.x * mapSize.y * mapSize.z;
+
+	parent.assign(tilesCount, NOT_AVAILABLE);
+	rank.assign(tilesCount, 0);
+	water.assign(tilesCount, false);
+	changedTiles.clear();
+
+	for(int x = 0; x < mapSize.x; x++)
+	{
+		for(int y = 0; y < mapSize.y; y++)
+		{
+			for(int z = 0; z < mapSize.z; z++)
 			{
-				return ret;
-				//throw cannotFulfillGoalException("Land-land and water-water inter-sector transitions are not implemented!");
+				const int3 pos(x, y, z);
+				const TerrainTile * tileInfo = getTile(pos);
+
+				if(tileInfo && isPassable(tileInfo))
+					addTile(pos, tileInfo);
 			}
 		}
-		else
-		{
-			return ret;
-			//throw cannotFulfillGoalException("Inter-sector route detection failed: not connected sectors?");
-		}
-	}
-	else //tiles are in same sector
-	{
-		return findFirstVisitableTile(h, dst);
 	}
+
+	valid = true;
+	embarkmentPointsValid = false;
 }
 
-int3 SectorMap::findFirstVisitableTile(HeroPtr h, crint3 dst)
+void SectorMap::prepare()
 {
-	int3 ret(-1, -1, -1);
-	int3 curtile = dst;
-
-	while (curtile != h->visitablePos())
+	for(auto removed = removedObjects.begin(); removed != removedObjects.end();)
 	{
-		auto topObj = cb->getTopObj(curtile);
-		if (topObj && topObj->ID == Obj::HERO && topObj != h.h)
+		if(isObjectOnTheMap(removed->first))
 		{
-			if (cb->getPlayerRelations(h->tempOwner, topObj->tempOwner) != PlayerRelations::ENEMIES)
-			{
-				logAi->warn("Another allied hero stands in our way");
-				return ret;
-			}
+			++removed;
 		}
-		if (ai->myCb->getPathsInfo(h.get())->getPathInfo(curtile)->reachable())
+		else
 		{
-			return curtile;
+			changedTiles.insert(removed->second.begin(), removed->second.end());
+			removed = removedObjects.erase(removed);
 		}
-		else
+	}
+
+	if(valid && !changedTiles.empty())
+	{
+		embarkmentPointsValid = false;
+
+		for(const int3 & tile : changedTiles)
 		{
-			auto i = parent.find(curtile);
-			if (i != parent.end())
+			const TerrainTile * tileInfo = getTile(tile);
+			const bool passable = tileInfo && isPassable(tileInfo);
+			const bool wasPassable = parent[getTileIndex(tile)] != NOT_AVAILABLE;
+
+			if(passable && !wasPassable)
 			{
-				assert(curtile != i->second);
-				curtile = i->second;
+				addTile(tile, tileInfo);
 			}
-			else
+			else if(!passable && wasPassable)
 			{
-				return ret;
-				//throw cannotFulfillGoalException("Unreachable tile in sector? Should not happen!");
+				valid = false; //disjoint sets can not be split
+				break;
 			}
 		}
+
+		changedTiles.clear();
 	}
-	return ret;
+
+	if(!valid)
+		build();
 }
 
-void SectorMap::makeParentBFS(crint3 source)
+void SectorMap::calculateEmbarkmentPoints()
 {
-	parent.clear();
+	nearestEmbarkmentPoint.assign(parent.size(), NOT_AVAILABLE);
 
-	int mySector = retrieveTile(source);
-	std::queue<int3> toVisit;
-	toVisit.push(source);
-	while (!toVisit.empty())
+	std::queue<TSectorID> toVisit;
+
+	for(TSectorID index = 0; index < (TSectorID)parent.size(); index++)
 	{
-		int3 curPos = toVisit.front();
+		if(parent[index] == NOT_AVAILABLE)
+			continue;
+
+		forEachNeighbour(getTilePos(index), [&](const int3 & neighbour)
+		{
+			const TSectorID neighbourIndex = getTileIndex(neighbour);
+
+			if(nearestEmbarkmentPoint[index] == NOT_AVAILABLE
+				&& parent[neighbourIndex] != NOT_AVAILABLE
+				&& water[neighbourIndex] != water[index]
+				&& canBeEmbarkmentPoint(getTile(neighbour), water[index]))
+			{
+				nearestEmbarkmentPoint[index] = neighbourIndex;
+			}
+		});
+
+		if(nearestEmbarkmentPoint[index] != NOT_AVAILABLE)
+			toVisit.push(index);
+	}
+
+	//spread the closest points through sectors, breadth-first so every tile gets the nearest one
+	while(!toVisit.empty())
+	{
+		const TSectorID index = toVisit.front();
 		toVisit.pop();
-		TSectorID & sec = retrieveTile(curPos);
-		assert(sec == mySector); //consider only tiles from the same sector
-		UNUSED(sec);
 
-		foreach_neighbour(curPos, [&](crint3 neighPos)
+		forEachNeighbour(getTilePos(index), [&](const int3 & neighbour)
 		{
-			if (retrieveTile(neighPos) == mySector && !vstd::contains(parent, neighPos))
+			const TSectorID neighbourIndex = getTileIndex(neighbour);
+
+			if(parent[neighbourIndex] != NOT_AVAILABLE
+				&& water[neighbourIndex] == water[index]
+				&& nearestEmbarkmentPoint[neighbourIndex] == NOT_AVAILABLE)
 			{
-				if (cb->canMoveBetween(curPos, neighPos))
-				{
-					toVisit.push(neighPos);
-					parent[neighPos] = curPos;
-				}
+				nearestEmbarkmentPoint[neighbourIndex] = nearestEmbarkmentPoint[index];
+				toVisit.push(neighbourIndex);
 			}
 		});
 	}
+
+	embarkmentPointsValid = true;
+}
+
+void SectorMap::reset()
+{
+	boost::unique_lock<boost::mutex> lock(sectorMutex);
+
+	valid = false;
+	embarkmentPointsValid = false;
+	changedTiles.clear();
+	removedObjects.clear();
 }
 
-SectorMap::TSectorID & SectorMap::retrieveTile(crint3 pos)
+void SectorMap::update(const std::unordered_set<int3, ShashInt3> & tiles)
 {
-	return retrieveTileN(sector, pos);
+	boost::unique_lock<boost::mutex> lock(sectorMutex);
+
+	if(valid)
+		changedTiles.insert(tiles.begin(), tiles.end());
 }
 
-TerrainTile * SectorMap::getTile(crint3 pos) const
+void SectorMap::update(const CGObjectInstance * obj)
 {
-	//out of bounds access should be handled by boost::multi_array
-	//still we cached this array to avoid any checks
-	return visibleTiles->operator[](pos.x)[pos.y][pos.z];
+	boost::unique_lock<boost::mutex> lock(sectorMutex);
+
+	if(!valid)
+		return;
+
+	for(const int3 & tile : getObjectTiles(obj))
+		changedTiles.insert(tile);
 }
 
-std::vector<const CGObjectInstance *> SectorMap::getNearbyObjs(HeroPtr h, bool sectorsAround)
+void SectorMap::objectRemoved(const CGObjectInstance * obj)
 {
-	const Sector * heroSector = &infoOnSectors[retrieveTile(h->visitablePos())];
-	if (sectorsAround)
-	{
-		std::vector<const CGObjectInstance *> ret;
-		for (auto embarkPoint : heroSector->embarkmentPoints)
-		{
-			const Sector * embarkSector = &infoOnSectors[retrieveTile(embarkPoint)];
-			range::copy(embarkSector->visitableObjs, std::back_inserter(ret));
-		}
-		return ret;
-	}
-	return heroSector->visitableObjs;
-}
\ No newline at end of file
+	boost::unique_lock<boost::mutex> lock(sectorMutex);
+
+	//sectors built later see the map without the object
+	if(!valid)
+		return;
+
+	removedObjects[obj->id] = getObjectTiles(obj);
+}
+
+SectorMap::TSectorID SectorMap::getSector(const int3 & tile)
+{
+	boost::unique_lock<boost::mutex> lock(sectorMutex);
+
+	prepare();
+
+	const TSectorID index = getTileIndex(tile);
+
+	return parent[index] == NOT_AVAILABLE ? NOT_AVAILABLE : find(index);
+}
+
+bool SectorMap::isSameSector(const int3 & first, const int3 & second)
+{
+	const TSectorID sector = getSector(first);
+
+	return sector != NOT_AVAILABLE && sector == getSector(second);
+}
+
+int3 SectorMap::getNearestEmbarkmentPoint(const int3 & tile)
+{
+	boost::unique_lock<boost::mutex> lock(sectorMutex);
+
+	prepare();
+
+	if(!embarkmentPointsValid)
+		calculateEmbarkmentPoints();
+
+	const TSectorID point = nearestEmbarkmentPoint[getTileIndex(tile)];
+
+	return point == NOT_AVAILABLE ? int3(-1, -1, -1) : getTilePos(point);
+}
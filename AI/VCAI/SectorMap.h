@@ -11,60 +11,76 @@
 
 #pragma once
 
-#include "AIUtility.h"
+#include "../../lib/int3.h"
+#include "../../lib/GameConstants.h"
 
-enum
-{
-	NOT_VISIBLE = 0,
-	NOT_CHECKED = 1,
-	NOT_AVAILABLE
-};
+class CGObjectInstance;
+struct TerrainTile;
 
-struct SectorMap
+/// A sector is set of visible land or water tiles that would be mutually reachable if all visitable objs would be passable (incl monsters).
+/// Sectors are kept as disjoint sets over the whole map, built on first query. Tiles which became visible or passable
+/// are merged into sectors incrementally, only a tile which became blocked or hidden makes the map to be built again.
+class SectorMap
 {
-	//a sector is set of tiles that would be mutually reachable if all visitable objs would be passable (incl monsters)
-	struct Sector
-	{
-		int id;
-		std::vector<int3> tiles;
-		std::vector<int3> embarkmentPoints; //tiles of other sectors onto which we can (dis)embark
-		std::vector<const CGObjectInstance *> visitableObjs;
-		bool water; //all tiles of sector are land or water
-		Sector()
-		{
-			id = -1;
-			water = false;
-		}
-	};
-
-	typedef unsigned short TSectorID; //smaller than int to allow -1 value. Max number of sectors 65K should be enough for any proper map.
-	typedef boost::multi_array<TSectorID, 3> TSectorArray;
-
-	bool valid; //some kind of lazy eval
-	std::map<int3, int3> parent;
-	TSectorArray sector;
-	//std::vector<std::vector<std::vector<unsigned char>>> pathfinderSector;
-
-	std::map<int, Sector> infoOnSectors;
-	std::shared_ptr<boost::multi_array<TerrainTile *, 3>> visibleTiles;
+public:
+	typedef si32 TSectorID;
+
+	static const TSectorID NOT_AVAILABLE = -1; //tile is hidden or blocked
+
+private:
+	int3 mapSize;
+	bool valid;
+	/// Disjoint set forest, tile index -> parent tile index, NOT_AVAILABLE for hidden or blocked tiles
+	std::vector<TSectorID> parent;
+	std::vector<ui8> rank;
+	std::vector<bool> water;
+	/// Tiles whose passability may have changed since last query
+	std::unordered_set<int3, ShashInt3> changedTiles;
+	/// Tiles of objects reported as removed, checked once the object is gone from the map
+	std::map<ObjectInstanceID, std::vector<int3>> removedObjects;
+
+	bool embarkmentPointsValid;
+	/// Tile index -> the nearest tile of other sector onto which hero can (dis)embark from the sector of the tile
+	std::vector<si32> nearestEmbarkmentPoint;
+
+	boost::mutex sectorMutex;
 
+	size_t getTileIndex(const int3 & tile) const;
+	int3 getTilePos(size_t index) const;
+	bool isInTheMap(const int3 & tile) const;
+	bool isPassable(const TerrainTile * tile) const;
+	std::vector<int3> getObjectTiles(const CGObjectInstance * obj) const;
+	void forEachNeighbour(const int3 & tile, std::function<void(const int3 &)> foo) const;
+
+	TSectorID find(TSectorID tile);
+	void unite(TSectorID first, TSectorID second);
+	void addTile(const int3 & tile, const TerrainTile * tileInfo);
+
+	void build();
+	void prepare();
+	void calculateEmbarkmentPoints();
+
+protected:
+	virtual int3 getMapSize() const;
+	/// nullptr if the tile is not visible
+	virtual const TerrainTile * getTile(const int3 & tile) const;
+	virtual bool isObjectOnTheMap(ObjectInstanceID id) const;
+
+public:
 	SectorMap();
-	SectorMap(HeroPtr h);
-	void update();
-	void clear();
-	void exploreNewSector(crint3 pos, int num, CCallback * cbp);
-	void write(crstring fname);
-
-	bool markIfBlocked(TSectorID & sec, crint3 pos, const TerrainTile * t);
-	bool markIfBlocked(TSectorID & sec, crint3 pos);
-	TSectorID & retrieveTile(crint3 pos);
-	TSectorID & retrieveTileN(TSectorArray & vectors, const int3 & pos);
-	const TSectorID & retrieveTileN(const TSectorArray & vectors, const int3 & pos);
-	TerrainTile * getTile(crint3 pos) const;
-	std::vector<const CGObjectInstance *> getNearbyObjs(HeroPtr h, bool sectorsAround);
-
-	void makeParentBFS(crint3 source);
-
-	int3 firstTileToGet(HeroPtr h, crint3 dst); //if h wants to reach tile dst, which tile he should visit to clear the way?
-	int3 findFirstVisitableTile(HeroPtr h, crint3 dst);
+	virtual ~SectorMap() = default;
+
+	/// Drops all sectors, the map is built again on next query
+	void reset();
+	/// Passability of tiles may have changed, they are checked on next query
+	void update(const std::unordered_set<int3, ShashInt3> & tiles);
+	void update(const CGObjectInstance * obj);
+	/// The object is still on the map when the AI is told about removal, its tiles are checked on the first query after it is gone
+	void objectRemoved(const CGObjectInstance * obj);
+
+	/// Sector identifiers are valid only until the map changes
+	TSectorID getSector(const int3 & tile);
+	bool isSameSector(const int3 & first, const int3 & second);
+	/// The nearest tile where hero standing at given tile can (dis)embark, int3(-1, -1, -1) if there is none
+	int3 getNearestEmbarkmentPoint(const int3 & tile);
 };
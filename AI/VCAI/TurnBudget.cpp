@@ -0,0 +1,116 @@
+/*
+* TurnBudget.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#include "StdInc.h"
+#include "TurnBudget.h"
+
+#include "../../lib/CConfigHandler.h"
+
+//goals realized quicker are not considered cheaper, measurement is too noisy
+static const double MIN_GOAL_MS = 1.0;
+//weight of newest sample in average realization time, so estimates follow changes of the map
+static const double GOAL_COST_SMOOTHING = 0.2;
+
+static double toMs(TurnBudget::TClock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+TurnBudget::PhaseTimer::PhaseTimer(TurnBudget & budget, const std::string & phase, Goals::TSubgoal goal)
+	: budget(budget), phase(phase), goal(goal), start(TClock::now())
+{
+}
+
+TurnBudget::PhaseTimer::~PhaseTimer()
+{
+	const double ms = toMs(TClock::now() - start);
+
+	budget.addPhaseTime(phase, ms);
+	if(goal)
+		budget.addGoalTime(goal->goalType, ms);
+}
+
+TurnBudget::TurnBudget()
+	: turnStart(TClock::now()), limit(TClock::duration::zero())
+{
+}
+
+void TurnBudget::startTurn()
+{
+	turnStart = TClock::now();
+	limit = std::chrono::duration_cast<TClock::duration>(std::chrono::duration<double>(settings["ai"]["turnTimeLimit"].Float()));
+	phaseTimes.clear();
+}
+
+void TurnBudget::endTurn(const PlayerColor & player) const
+{
+	std::string phases;
+	for(auto & phase : phaseTimes)
+		phases += boost::str(boost::format(", %s %.0f ms") % phase.first % phase.second);
+
+	if(isLimited())
+		logAi->info("Player %s turn took %.0f ms of %.0f ms%s", player.getStr(), getElapsedMs(), toMs(limit), phases);
+	else
+		logAi->info("Player %s turn took %.0f ms%s", player.getStr(), getElapsedMs(), phases);
+
+	for(auto & cost : goalCosts)
+		logAi->debug("Goal type %d is realized in %.1f ms on average (%d samples)", static_cast<int>(cost.first), cost.second.averageMs, cost.second.samples);
+}
+
+bool TurnBudget::isLimited() const
+{
+	return limit > TClock::duration::zero();
+}
+
+bool TurnBudget::isExhausted() const
+{
+	return isLimited() && TClock::now() - turnStart >= limit;
+}
+
+double TurnBudget::getElapsedMs() const
+{
+	return toMs(TClock::now() - turnStart);
+}
+
+Goals::TSubgoal TurnBudget::chooseByValuePerTime(const Goals::TGoalVec & goals) const
+{
+	//priorities are expected to be evaluated already
+	return *boost::max_element(goals, [&](const Goals::TSubgoal & lhs, const Goals::TSubgoal & rhs) -> bool
+	{
+		return lhs->priority / getExpectedMs(lhs->goalType) < rhs->priority / getExpectedMs(rhs->goalType);
+	});
+}
+
+void TurnBudget::addPhaseTime(const std::string & phase, double ms)
+{
+	phaseTimes[phase] += ms;
+}
+
+void TurnBudget::addGoalTime(Goals::EGoals goalType, double ms)
+{
+	auto it = goalCosts.find(goalType);
+	if(it == goalCosts.end())
+	{
+		goalCosts[goalType] = GoalCost{ms, 1};
+	}
+	else
+	{
+		it->second.averageMs += (ms - it->second.averageMs) * GOAL_COST_SMOOTHING;
+		it->second.samples++;
+	}
+}
+
+double TurnBudget::getExpectedMs(Goals::EGoals goalType) const
+{
+	auto it = goalCosts.find(goalType);
+	if(it == goalCosts.end())
+		return MIN_GOAL_MS; //not measured yet, give it a chance
+
+	return std::max(it->second.averageMs, MIN_GOAL_MS);
+}
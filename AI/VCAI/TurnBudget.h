@@ -0,0 +1,64 @@
+/*
+* TurnBudget.h, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#pragma once
+
+#include "Goals/AbstractGoal.h"
+
+/// Wall-clock budget of a single AI turn. Keeps track of where turn time went and of average
+/// realization time of each goal type, so goals can be ranked by value per millisecond.
+class TurnBudget
+{
+public:
+	typedef std::chrono::steady_clock TClock;
+
+	/// Adds time spent in scope to the phase, and to realization time of goal type if goal is given
+	class PhaseTimer
+	{
+	public:
+		PhaseTimer(TurnBudget & budget, const std::string & phase, Goals::TSubgoal goal = Goals::TSubgoal());
+		~PhaseTimer();
+
+	private:
+		TurnBudget & budget;
+		std::string phase;
+		Goals::TSubgoal goal;
+		TClock::time_point start;
+	};
+
+	TurnBudget();
+
+	/// Starts measuring new turn, limit is read from settings
+	void startTurn();
+	/// Logs time of the turn per phase
+	void endTurn(const PlayerColor & player) const;
+
+	bool isLimited() const;
+	bool isExhausted() const;
+	double getElapsedMs() const;
+
+	/// Goal with the highest priority per expected millisecond of realization
+	Goals::TSubgoal chooseByValuePerTime(const Goals::TGoalVec & goals) const;
+
+private:
+	struct GoalCost
+	{
+		double averageMs;
+		int samples;
+	};
+
+	TClock::time_point turnStart;
+	TClock::duration limit; //zero if turn is unlimited
+	std::map<std::string, double> phaseTimes; //milliseconds spent in phases this turn
+	std::map<Goals::EGoals, GoalCost> goalCosts; //kept between turns
+
+	void addPhaseTime(const std::string & phase, double ms);
+	void addGoalTime(Goals::EGoals goalType, double ms);
+	double getExpectedMs(Goals::EGoals goalType) const;
+};
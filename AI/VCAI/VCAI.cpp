@@ -20,6 +20,7 @@
 #include "../../lib/CHeroHandler.h"
 #include "../../lib/CModHandler.h"
 #include "../../lib/CGameState.h"
+#include "../../lib/CTurnMetrics.h"
 #include "../../lib/NetPacks.h"
 #include "../../lib/serializer/CTypeList.h"
 #include "../../lib/serializer/BinarySerializer.h"
@@ -27,7 +28,7 @@
 
 #include "AIhelper.h"
 
-extern FuzzyHelper * fh;
+extern boost::thread_specific_ptr<FuzzyHelper> fh;
 
 class CGVisitableOPW;
 
@@ -49,6 +50,7 @@ struct SetGlobalState
 
 		ai.reset(AI);
 		cb.reset(AI->myCb.get());
+		fh.reset(AI->fuzzyHelper.get());
 	}
 	~SetGlobalState()
 	{
@@ -56,6 +58,7 @@ struct SetGlobalState
 		//TODO: to ensure that, make rm unique_ptr
 		ai.release();
 		cb.release();
+		fh.release();
 	}
 };
 
@@ -74,6 +77,7 @@ VCAI::VCAI()
 
 	ah = new AIhelper();
 	ah->setAI(this);
+	fuzzyHelper = make_unique<FuzzyHelper>();
 }
 
 VCAI::~VCAI()
@@ -81,6 +85,7 @@ VCAI::~VCAI()
 	delete ah;
 	LOG_TRACE(logAi);
 	finish();
+	workerPool.reset();
 }
 
 void VCAI::availableCreaturesChanged(const CGDwelling * town)
@@ -96,10 +101,13 @@ void VCAI::heroMoved(const TryMoveHero & details)
 
 	validateObject(details.id); //enemy hero may have left visible area
 	auto hero = cb->getHero(details.id);
-	ah->resetPaths();
 
 	const int3 from = CGHeroInstance::convertPosition(details.start, false);
 	const int3 to = CGHeroInstance::convertPosition(details.end, false);
+	dangerMap.invalidateAround(from);
+	dangerMap.invalidateAround(to);
+	ah->invalidatePaths(from); //paths of the moving hero itself are recalculated as its position changed
+	ah->invalidatePaths(to);
 	const CGObjectInstance * o1 = vstd::frontOrNull(cb->getVisitableObjs(from));
 	const CGObjectInstance * o2 = vstd::frontOrNull(cb->getVisitableObjs(to));
 
@@ -247,6 +255,7 @@ void VCAI::heroVisit(const CGHeroInstance * visitor, const CGObjectInstance * vi
 		//TODO: what if we visited one-time visitable object that was reserved by another hero (shouldn't, but..)
 		if (visitedObj->ID == Obj::HERO)
 		{
+			boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
 			visitedHeroes[visitor].insert(HeroPtr(dynamic_cast<const CGHeroInstance *>(visitedObj)));
 		}
 	}
@@ -273,8 +282,12 @@ void VCAI::tileHidden(const std::unordered_set<int3, ShashInt3> & pos)
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
 
+	for(int3 tile : pos)
+		dangerMap.invalidateAround(tile);
+
+	fogMap.update(pos);
 	validateVisitableObjs();
-	clearPathsInfo();
+	clearPathsInfo(pos);
 }
 
 void VCAI::tileRevealed(const std::unordered_set<int3, ShashInt3> & pos)
@@ -284,10 +297,15 @@ void VCAI::tileRevealed(const std::unordered_set<int3, ShashInt3> & pos)
 	for(int3 tile : pos)
 	{
 		for(const CGObjectInstance * obj : myCb->getVisitableObjs(tile))
+		{
 			addVisitableObj(obj);
+			ah->invalidatePaths(obj); //revealed teleport may lead anywhere
+		}
+		dangerMap.invalidateAround(tile);
 	}
 
-	clearPathsInfo();
+	fogMap.update(pos);
+	clearPathsInfo(pos);
 }
 
 void VCAI::heroExchangeStarted(ObjectInstanceID hero1, ObjectInstanceID hero2, QueryID query)
@@ -368,6 +386,15 @@ void VCAI::garrisonsChanged(ObjectInstanceID id1, ObjectInstanceID id2)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+
+	for(auto id : {id1, id2})
+	{
+		if(auto obj = myCb->getObj(id, false))
+		{
+			dangerMap.invalidateAround(obj);
+			ah->invalidatePaths(obj);
+		}
+	}
 }
 
 void VCAI::newObject(const CGObjectInstance * obj)
@@ -377,7 +404,8 @@ void VCAI::newObject(const CGObjectInstance * obj)
 	if(obj->isVisitable())
 		addVisitableObj(obj);
 
-	ah->resetPaths();
+	dangerMap.invalidateAround(obj);
+	ah->invalidatePaths(obj);
 }
 
 //to prevent AI from accessing objects that got deleted while they became invisible (Cover of Darkness, enemy hero moved etc.) below code allows AI to know deletion of objects out of sight
@@ -389,6 +417,7 @@ void VCAI::objectRemoved(const CGObjectInstance * obj)
 
 	vstd::erase_if_present(visitableObjs, obj);
 	vstd::erase_if_present(alreadyVisited, obj);
+	dangerMap.invalidateAround(obj);
 
 	for(auto h : cb->getHeroesInfo())
 		unreserveObject(h, obj);
@@ -437,7 +466,7 @@ void VCAI::objectRemoved(const CGObjectInstance * obj)
 		}
 	}
 
-	ah->resetPaths();
+	ah->invalidatePaths(obj);
 
 	//TODO
 	//there are other places where CGObjectinstance ptrs are stored...
@@ -470,7 +499,10 @@ void VCAI::heroCreated(const CGHeroInstance * h)
 {
 	LOG_TRACE(logAi);
 	if(h->visitedTown)
+	{
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
 		townVisitsThisWeek[HeroPtr(h)].insert(h->visitedTown);
+	}
 	NET_EVENT_HANDLER;
 }
 
@@ -541,6 +573,12 @@ void VCAI::objectPropertyChanged(const SetObjectProperty * sop)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+	if(auto changedObj = myCb->getObj(sop->id, false))
+	{
+		dangerMap.invalidateAround(changedObj);
+		ah->invalidatePaths(changedObj);
+	}
+
 	if(sop->what == ObjProperty::OWNER)
 	{
 		if(myCb->getPlayerRelations(playerID, (PlayerColor)sop->val) == PlayerRelations::ENEMIES)
@@ -563,12 +601,18 @@ void VCAI::buildChanged(const CGTownInstance * town, BuildingID buildingID, int
 
 	if(town->getOwner() == playerID && what == 1) //built
 		completeGoal(sptr(Goals::BuildThis(buildingID, town)));
+
+	if(buildingID == BuildingID::SHIPYARD)
+		ah->invalidatePaths(town);
 }
 
 void VCAI::heroBonusChanged(const CGHeroInstance * hero, const Bonus & bonus, bool gain)
 {
 	LOG_TRACE_PARAMS(logAi, "gain '%i'", gain);
 	NET_EVENT_HANDLER;
+
+	//bonuses like flying or water walking change paths of the hero
+	ah->invalidatePaths(hero);
 }
 
 void VCAI::showMarketWindow(const IMarket * market, const CGHeroInstance * visitor)
@@ -597,9 +641,6 @@ void VCAI::init(std::shared_ptr<CCallback> CB)
 	myCb->waitTillRealize = true;
 	myCb->unlockGsWhenWaiting = true;
 
-	if(!fh)
-		fh = new FuzzyHelper();
-
 	retrieveVisitableObjs();
 }
 
@@ -657,6 +698,7 @@ void VCAI::showTeleportDialog(TeleportChannelID channel, TTeleportExitsList exit
 	int choosenExit = -1;
 	if(impassable)
 	{
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
 		knownTeleportChannels[channel]->passability = TeleportChannel::IMPASSABLE;
 	}
 	else if(destinationTeleport != ObjectInstanceID() && destinationTeleportPos.valid())
@@ -774,12 +816,20 @@ void VCAI::makeTurn()
 
 	boost::shared_lock<boost::shared_mutex> gsLock(CGameState::mutex);
 	setThreadName("VCAI::makeTurn");
+	dangerMap.reset();
+	turnBudget.startTurn();
+	turnMetrics.startTurn(playerID, day);
 
 	switch(cb->getDate(Date::DAY_OF_WEEK))
 	{
 	case 1:
 	{
-		townVisitsThisWeek.clear();
+		//armies of guards have grown, paths of heroes which did not change are kept between other turns
+		ai->ah->resetPaths();
+		{
+			boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+			townVisitsThisWeek.clear();
+		}
 		std::vector<const CGObjectInstance *> objs;
 		retrieveVisitableObjs(objs, true);
 		for(const CGObjectInstance * obj : objs)
@@ -794,8 +844,10 @@ void VCAI::makeTurn()
 	}
 	}
 	markHeroAbleToExplore(primaryHero());
-	visitedHeroes.clear();
-	ai->ah->resetPaths();
+	{
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+		visitedHeroes.clear();
+	}
 
 	try
 	{
@@ -807,7 +859,10 @@ void VCAI::makeTurn()
 
 		/*Below function is also responsible for hero movement via internal wander function. By design it is separate logic for heroes that have nothing to do.
 		Heroes that were not picked by striveToGoal(sptr(Goals::Win())); recently (so they do not have new goals and cannot continue/reevaluate previously locked goals) will do logic in wander().*/
-		performTypicalActions();
+		{
+			TurnBudget::PhaseTimer timer(turnBudget, "typical actions");
+			performTypicalActions();
+		}
 
 		//for debug purpose
 		for (auto h : cb->getHeroesInfo())
@@ -826,6 +881,8 @@ void VCAI::makeTurn()
 		logAi->debug("Making turn thread has caught an exception: %s", e.what());
 	}
 
+	turnBudget.endTurn(playerID);
+	turnMetrics.endTurn(playerID);
 	endTurn();
 }
 
@@ -856,6 +913,13 @@ void VCAI::mainLoop()
 
 	while (basicGoals.size())
 	{
+		//anytime behaviour: goals already assigned to heroes are kept and continued next turn
+		if (turnBudget.isExhausted())
+		{
+			logAi->info("Main loop: turn time limit reached after %.0f ms, stopping with %i basic goals left", turnBudget.getElapsedMs(), basicGoals.size());
+			break;
+		}
+
 		vstd::removeDuplicates(basicGoals); //TODO: container which does this automagically without has would be nice
 		goalsToAdd.clear();
 		goalsToRemove.clear();
@@ -864,58 +928,33 @@ void VCAI::mainLoop()
 
 		logAi->debug("Main loop: decomposing %i basic goals", basicGoals.size());
 
-		for (auto basicGoal : basicGoals)
+		//decomposition of basic goals is independent, gather results and apply them in order of basic goals
+		std::vector<BasicGoalDecomposition> decompositions(basicGoals.size());
+		std::vector<std::function<void()>> decompositionTasks;
+		for (size_t i = 0; i < basicGoals.size(); i++)
+		{
+			decompositionTasks.push_back([this, i, &decompositions]()
+			{
+				decompositions[i] = decomposeBasicGoal(basicGoals[i]);
+			});
+		}
+
 		{
-			logAi->debug("Main loop: decomposing basic goal %s", basicGoal->name());
+			TurnBudget::PhaseTimer timer(turnBudget, "decomposition");
+			executeTasks(decompositionTasks);
+		}
 
-			auto goalToDecompose = basicGoal;
-			Goals::TSubgoal elementarGoal = sptr(Goals::Invalid());
-			int maxAbstractGoals = 10;
-			while (!elementarGoal->isElementar && maxAbstractGoals)
+		for (auto & decomposition : decompositions)
+		{
+			for (auto goal : decomposition.completedGoals)
+				completeGoal(goal); //put in goalsToRemove
+			vstd::concatenate(goalsToRemove, decomposition.failedGoals);
+			vstd::concatenate(goalsToAdd, decomposition.abstractGoals);
+
+			if (decomposition.elementarGoal)
 			{
-				try
-				{
-					elementarGoal = decomposeGoal(goalToDecompose);
-				}
-				catch (goalFulfilledException & e)
-				{
-					//it is impossible to continue some goals (like exploration, for example)
-					//complete abstract goal for now, but maybe main goal finds another path
-					logAi->debug("Goal %s decomposition failed: goal was completed as much as possible", e.goal->name());
-					completeGoal(e.goal); //put in goalsToRemove
-					break;
-				}
-				catch(cannotFulfillGoalException & e)
-				{
-					//it is impossible to continue some goals (like exploration, for example)
-					//complete abstract goal for now, but maybe main goal finds another path
-					goalsToRemove.push_back(basicGoal);
-					logAi->debug("Goal %s decomposition failed: %s", goalToDecompose->name(), e.what());
-					break;
-				}
-				catch (std::exception & e) //decomposition failed, which means we can't decompose entire tree
-				{
-					goalsToRemove.push_back(basicGoal);
-					logAi->debug("Goal %s decomposition failed: %s", basicGoal->name(), e.what());
-					break;
-				}
-				if (elementarGoal->isAbstract) //we can decompose it further
-				{
-					goalsToAdd.push_back(elementarGoal);
-					//decompose further now - this is necesssary if we can't add over 10 goals in the pool
-					goalToDecompose = elementarGoal;
-					//there is a risk of infinite abstract goal loop, though it indicates failed logic
-					maxAbstractGoals--;
-				}
-				else if (elementarGoal->isElementar) //should be
-				{
-					logAi->debug("Found elementar goal %s", elementarGoal->name());
-					elementarGoals.push_back(elementarGoal);
-					ultimateGoalsFromBasic[elementarGoal].push_back(goalToDecompose); //TODO: how about indirect basicGoal?
-					break;
-				}
-				else //should never be here
-					throw cannotFulfillGoalException("Goal %s is neither abstract nor elementar!" + basicGoal->name());
+				elementarGoals.push_back(decomposition.elementarGoal);
+				ultimateGoalsFromBasic[decomposition.elementarGoal].push_back(decomposition.ultimateGoal); //TODO: how about indirect basicGoal?
 			}
 		}
 
@@ -929,7 +968,13 @@ void VCAI::mainLoop()
 			//allow assign goals to heroes with 0 movement, but don't realize them
 			//maybe there are beter ones left
 
-			auto bestGoal = fh->chooseSolution(possibleGoals);
+			Goals::TSubgoal bestGoal;
+			{
+				TurnBudget::PhaseTimer timer(turnBudget, "selection");
+				bestGoal = fh->chooseSolution(possibleGoals);
+				if (turnBudget.isLimited()) //prefer goals which are quick to realize, priorities are already evaluated
+					bestGoal = turnBudget.chooseByValuePerTime(possibleGoals);
+			}
 			if (bestGoal->hero) //lock this hero to fulfill goal
 			{
 				setGoal(bestGoal->hero, bestGoal);
@@ -954,6 +999,7 @@ void VCAI::mainLoop()
 
 			try
 			{
+				TurnBudget::PhaseTimer timer(turnBudget, "realization", goalToRealize);
 				boost::this_thread::interruption_point();
 				goalToRealize->accept(this); //visitor pattern
 				boost::this_thread::interruption_point();
@@ -1015,6 +1061,94 @@ void VCAI::mainLoop()
 	}
 }
 
+VCAI::BasicGoalDecomposition VCAI::decomposeBasicGoal(Goals::TSubgoal basicGoal)
+{
+	logAi->debug("Main loop: decomposing basic goal %s", basicGoal->name());
+
+	BasicGoalDecomposition result;
+	auto goalToDecompose = basicGoal;
+	Goals::TSubgoal elementarGoal = sptr(Goals::Invalid());
+	int maxAbstractGoals = 10;
+	while (!elementarGoal->isElementar && maxAbstractGoals)
+	{
+		try
+		{
+			elementarGoal = decomposeGoal(goalToDecompose);
+		}
+		catch (goalFulfilledException & e)
+		{
+			//it is impossible to continue some goals (like exploration, for example)
+			//complete abstract goal for now, but maybe main goal finds another path
+			logAi->debug("Goal %s decomposition failed: goal was completed as much as possible", e.goal->name());
+			result.completedGoals.push_back(e.goal);
+			break;
+		}
+		catch(cannotFulfillGoalException & e)
+		{
+			//it is impossible to continue some goals (like exploration, for example)
+			//complete abstract goal for now, but maybe main goal finds another path
+			result.failedGoals.push_back(basicGoal);
+			logAi->debug("Goal %s decomposition failed: %s", goalToDecompose->name(), e.what());
+			break;
+		}
+		catch (std::exception & e) //decomposition failed, which means we can't decompose entire tree
+		{
+			result.failedGoals.push_back(basicGoal);
+			logAi->debug("Goal %s decomposition failed: %s", basicGoal->name(), e.what());
+			break;
+		}
+		if (elementarGoal->isAbstract) //we can decompose it further
+		{
+			result.abstractGoals.push_back(elementarGoal);
+			//decompose further now - this is necesssary if we can't add over 10 goals in the pool
+			goalToDecompose = elementarGoal;
+			//there is a risk of infinite abstract goal loop, though it indicates failed logic
+			maxAbstractGoals--;
+		}
+		else if (elementarGoal->isElementar) //should be
+		{
+			logAi->debug("Found elementar goal %s", elementarGoal->name());
+			result.elementarGoal = elementarGoal;
+			result.ultimateGoal = goalToDecompose;
+			break;
+		}
+		else //should never be here
+			throw cannotFulfillGoalException("Goal %s is neither abstract nor elementar!" + basicGoal->name());
+	}
+
+	return result;
+}
+
+void VCAI::executeTasks(std::vector<std::function<void()>> & tasks)
+{
+	const bool isMakingTurnThread = makingTurn && makingTurn->get_id() == boost::this_thread::get_id();
+	const size_t threadsCount = boost::thread::hardware_concurrency();
+
+	if(!isMakingTurnThread || threadsCount < 2 || tasks.size() < 2)
+	{
+		for(auto & task : tasks)
+			task();
+
+		return;
+	}
+
+	if(!workerPool)
+	{
+		while(workerFuzzyHelpers.size() < threadsCount)
+			workerFuzzyHelpers.push_back(make_unique<FuzzyHelper>());
+
+		workerPool = make_unique<WorkerPool>(threadsCount, [this](size_t worker, const std::function<void()> & loop)
+		{
+			SET_GLOBAL_STATE(this);
+			fh.release();
+			fh.reset(workerFuzzyHelpers[worker].get());
+			loop();
+		});
+	}
+
+	workerPool->run(tasks);
+}
+
 void VCAI::performObjectInteraction(const CGObjectInstance * obj, HeroPtr h)
 {
 	LOG_TRACE_PARAMS(logAi, "Hero %s and object %s at %s", h->name % obj->getObjectName() % obj->pos.toString());
@@ -1028,7 +1162,10 @@ void VCAI::performObjectInteraction(const CGObjectInstance * obj, HeroPtr h)
 		moveCreaturesToHero(dynamic_cast<const CGTownInstance *>(obj));
 		if(h->visitedTown) //we are inside, not just attacking
 		{
-			townVisitsThisWeek[h].insert(h->visitedTown);
+			{
+				boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+				townVisitsThisWeek[h].insert(h->visitedTown);
+			}
 			if(!h->hasSpellbook() && ah->freeGold() >= GameConstants::SPELLBOOK_GOLD_COST)
 			{
 				if(h->visitedTown->hasBuilt(BuildingID::MAGES_GUILD_1))
@@ -1315,7 +1452,7 @@ bool VCAI::isGoodForVisit(const CGObjectInstance * obj, HeroPtr h, const AIPath
 		return false;
 	if (vstd::contains(alreadyVisited, obj))
 		return false;
-	if (vstd::contains(reservedObjs, obj))
+	if (isObjectReserved(obj))
 		return false;
 
 	// TODO: looks extra if we already have AIPath
@@ -1336,9 +1473,14 @@ bool VCAI::isTileNotReserved(const CGHeroInstance * h, int3 t) const
 	if(t.valid())
 	{
 		auto obj = cb->getTopObj(t);
-		if(obj && vstd::contains(ai->reservedObjs, obj)
-			&& vstd::contains(reservedHeroesMap, h)
-			&& !vstd::contains(reservedHeroesMap.at(h), obj))
+		if(!obj)
+			return true;
+
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+		auto reserved = reservedHeroesMap.find(h);
+		if(vstd::contains(reservedObjs, obj)
+			&& reserved != reservedHeroesMap.end()
+			&& !vstd::contains(reserved->second, obj))
 			return false; //do not capture object reserved by another hero
 		else
 			return true;
@@ -1372,7 +1514,10 @@ void VCAI::wander(HeroPtr h)
 	{
 		if (h->visitedTown)
 		{
-			townVisitsThisWeek[h].insert(h->visitedTown);
+			{
+				boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+				townVisitsThisWeek[h].insert(h->visitedTown);
+			}
 			buildArmyIn(h->visitedTown);
 			return true;
 		}
@@ -1380,8 +1525,7 @@ void VCAI::wander(HeroPtr h)
 	};
 
 	//unclaim objects that are now dangerous for us
-	auto reservedObjsSetCopy = reservedHeroesMap[h];
-	for(auto obj : reservedObjsSetCopy)
+	for(auto obj : getReservedObjects(h))
 	{
 		if(!isSafeToVisit(h, obj->visitablePos()))
 			unreserveObject(h, obj);
@@ -1395,7 +1539,7 @@ void VCAI::wander(HeroPtr h)
 		std::vector<ObjectIdRef> dests;
 
 		//also visit our reserved objects - but they are not prioritized to avoid running back and forth
-		vstd::copy_if(reservedHeroesMap[h], std::back_inserter(dests), [&](ObjectIdRef obj) -> bool
+		vstd::copy_if(getReservedObjects(h), std::back_inserter(dests), [&](ObjectIdRef obj) -> bool
 		{
 			return ah->getPathsToTile(h, obj->visitablePos()).size();
 		});
@@ -1444,7 +1588,7 @@ void VCAI::wander(HeroPtr h)
 			std::vector<const CGTownInstance *> townsNotReachable;
 			for(const CGTownInstance * t : cb->getTownsInfo())
 			{
-				if(!t->visitingHero && !vstd::contains(townVisitsThisWeek[h], t))
+				if(!t->visitingHero && !hasVisitedTownThisWeek(h, t))
 				{
 					if(isAccessibleForHero(t->visitablePos(), h))
 						townsReachable.push_back(t);
@@ -1626,6 +1770,7 @@ void VCAI::battleEnd(const BattleResult * br)
 	bool won = br->winner == myCb->battleGetMySide();
 	logAi->debug("Player %d (%s): I %s the %s!", playerID, playerID.getStr(), (won ? "won" : "lost"), battlename);
 	battlename.clear();
+	dangerMap.reset(); //armies of both sides have changed
 	CAdventureAI::battleEnd(br);
 }
 
@@ -1650,33 +1795,97 @@ void VCAI::markObjectVisited(const CGObjectInstance * obj)
 
 void VCAI::reserveObject(HeroPtr h, const CGObjectInstance * obj)
 {
-	reservedObjs.insert(obj);
-	reservedHeroesMap[h].insert(obj);
+	{
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+		reservedObjs.insert(obj);
+		reservedHeroesMap[h].insert(obj);
+	}
 	logAi->debug("reserved object id=%d; address=%p; name=%s", obj->id, obj, obj->getObjectName());
 }
 
 void VCAI::unreserveObject(HeroPtr h, const CGObjectInstance * obj)
 {
+	boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
 	vstd::erase_if_present(reservedObjs, obj); //unreserve objects
-	vstd::erase_if_present(reservedHeroesMap[h], obj);
+	auto reserved = reservedHeroesMap.find(h);
+	if(reserved != reservedHeroesMap.end())
+		vstd::erase_if_present(reserved->second, obj);
+}
+
+std::set<const CGObjectInstance *> VCAI::getReservedObjects(HeroPtr h) const
+{
+	boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+	auto reserved = reservedHeroesMap.find(h);
+	if(reserved == reservedHeroesMap.end())
+		return std::set<const CGObjectInstance *>();
+
+	return reserved->second;
+}
+
+bool VCAI::isObjectReserved(const CGObjectInstance * obj) const
+{
+	boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+	return vstd::contains(reservedObjs, obj);
+}
+
+bool VCAI::isReservedByOtherHero(HeroPtr h, const CGObjectInstance * obj) const
+{
+	boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+	if(!vstd::contains(reservedObjs, obj))
+		return false;
+
+	auto reserved = reservedHeroesMap.find(h);
+	return reserved == reservedHeroesMap.end() || !vstd::contains(reserved->second, obj);
+}
+
+bool VCAI::hasVisitedTownThisWeek(HeroPtr h, const CGTownInstance * t) const
+{
+	boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+	auto visits = townVisitsThisWeek.find(h);
+	return visits != townVisitsThisWeek.end() && vstd::contains(visits->second, t);
+}
+
+bool VCAI::hasVisitedHero(HeroPtr visitor, HeroPtr visited) const
+{
+	boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+	auto visits = visitedHeroes.find(visitor);
+	return visits != visitedHeroes.end() && vstd::contains(visits->second, visited);
+}
+
+boost::optional<TeleportChannel> VCAI::getKnownTeleportChannel(TeleportChannelID channel) const
+{
+	boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+	auto known = knownTeleportChannels.find(channel);
+	if(known == knownTeleportChannels.end())
+		return boost::none;
+
+	return *known->second;
 }
 
 void VCAI::markHeroUnableToExplore(HeroPtr h)
 {
+	boost::unique_lock<boost::mutex> lock(heroesUnableToExploreMutex);
 	heroesUnableToExplore.insert(h);
 }
 void VCAI::markHeroAbleToExplore(HeroPtr h)
 {
+	boost::unique_lock<boost::mutex> lock(heroesUnableToExploreMutex);
 	vstd::erase_if_present(heroesUnableToExplore, h);
 }
 bool VCAI::isAbleToExplore(HeroPtr h)
 {
+	boost::unique_lock<boost::mutex> lock(heroesUnableToExploreMutex);
 	return !vstd::contains(heroesUnableToExplore, h);
 }
-void VCAI::clearPathsInfo()
+void VCAI::clearPathsInfo(const std::unordered_set<int3, ShashInt3> & changedTiles)
 {
-	heroesUnableToExplore.clear();
-	ah->resetPaths();
+	{
+		boost::unique_lock<boost::mutex> lock(heroesUnableToExploreMutex);
+		heroesUnableToExplore.clear();
+	}
+
+	for(const int3 & tile : changedTiles)
+		ah->invalidatePaths(tile);
 }
 
 void VCAI::validateVisitableObjs()
@@ -1694,19 +1903,22 @@ void VCAI::validateVisitableObjs()
 	errorMsg = " shouldn't be on the visitable objects list!";
 	vstd::erase_if(visitableObjs, shouldBeErased);
 
-	//FIXME: how comes our own heroes become inaccessible?
-	vstd::erase_if(reservedHeroesMap, [](std::pair<HeroPtr, std::set<const CGObjectInstance *>> hp) -> bool
 	{
-		return !hp.first.get(true);
-	});
-	for(auto & p : reservedHeroesMap)
-	{
-		errorMsg = " shouldn't be on list for hero " + p.first->name + "!";
-		vstd::erase_if(p.second, shouldBeErased);
-	}
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+		//FIXME: how comes our own heroes become inaccessible?
+		vstd::erase_if(reservedHeroesMap, [](std::pair<HeroPtr, std::set<const CGObjectInstance *>> hp) -> bool
+		{
+			return !hp.first.get(true);
+		});
+		for(auto & p : reservedHeroesMap)
+		{
+			errorMsg = " shouldn't be on list for hero " + p.first->name + "!";
+			vstd::erase_if(p.second, shouldBeErased);
+		}
 
-	errorMsg = " shouldn't be on the reserved objs list!";
-	vstd::erase_if(reservedObjs, shouldBeErased);
+		errorMsg = " shouldn't be on the reserved objs list!";
+		vstd::erase_if(reservedObjs, shouldBeErased);
+	}
 
 	//TODO overkill, hidden object should not be removed. However, we can't know if hidden object is erased from game.
 	errorMsg = " shouldn't be on the already visited objs list!";
@@ -1758,7 +1970,10 @@ void VCAI::addVisitableObj(const CGObjectInstance * obj)
 	// All teleport objects seen automatically assigned to appropriate channels
 	auto teleportObj = dynamic_cast<const CGTeleport *>(obj);
 	if(teleportObj)
+	{
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
 		CGTeleport::addToChannel(knownTeleportChannels, teleportObj);
+	}
 }
 
 const CGObjectInstance * VCAI::lookForArt(int aid) const
@@ -2435,6 +2650,12 @@ void VCAI::performTypicalActions()
 		if(!h) //hero might be lost. getUnblockedHeroes() called once on start of turn
 			continue;
 
+		if(turnBudget.isExhausted())
+		{
+			logAi->info("Turn time limit reached, remaining heroes will not wander");
+			break;
+		}
+
 		logAi->debug("Hero %s started wandering, MP=%d", h->name.c_str(), h->movement);
 		makePossibleUpgrades(*h);
 		pickBestArtifacts(*h);
@@ -2516,15 +2737,18 @@ void VCAI::lostHero(HeroPtr h)
 	logAi->debug("I lost my hero %s. It's best to forget and move on.", h.name);
 
 	vstd::erase_if_present(lockedHeroes, h);
-	for(auto obj : reservedHeroesMap[h])
-	{
-		vstd::erase_if_present(reservedObjs, obj); //unreserve all objects for that hero
-	}
-	vstd::erase_if_present(reservedHeroesMap, h);
-	vstd::erase_if_present(visitedHeroes, h);
-	for (auto heroVec : visitedHeroes)
 	{
-		vstd::erase_if_present(heroVec.second, h);
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
+		for(auto obj : reservedHeroesMap[h])
+		{
+			vstd::erase_if_present(reservedObjs, obj); //unreserve all objects for that hero
+		}
+		vstd::erase_if_present(reservedHeroesMap, h);
+		vstd::erase_if_present(visitedHeroes, h);
+		for (auto & heroVec : visitedHeroes)
+		{
+			vstd::erase_if_present(heroVec.second, h);
+		}
 	}
 
 	//remove goals with removed hero assigned from main loop
@@ -2598,6 +2822,7 @@ void VCAI::validateObject(ObjectIdRef obj)
 	{
 		vstd::erase_if(visitableObjs, matchesId);
 
+		boost::unique_lock<boost::mutex> lock(heroMemoryMutex);
 		for(auto & p : reservedHeroesMap)
 			vstd::erase_if(p.second, matchesId);
 
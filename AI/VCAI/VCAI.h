@@ -25,10 +25,15 @@
 #include "../../lib/spells/CSpellHandler.h"
 #include "../../lib/CondSh.h"
 #include "Pathfinding/AIPathfinder.h"
+#include "DangerMap.h"
+#include "FogMap.h"
+#include "TurnBudget.h"
+#include "WorkerPool.h"
 
 struct QuestInfo;
 
 class AIhelper;
+class FuzzyHelper;
 
 class AIStatus
 {
@@ -99,12 +104,15 @@ public:
 	std::map<HeroPtr, Goals::TSubgoal> lockedHeroes; //TODO: allow non-elementar objectives
 	std::map<HeroPtr, std::set<const CGObjectInstance *>> reservedHeroesMap; //objects reserved by specific heroes
 	std::set<HeroPtr> heroesUnableToExplore; //these heroes will not be polled for exploration in current state of game
+	boost::mutex heroesUnableToExploreMutex;
 
 	//sets are faster to search, also do not contain duplicates
 	std::set<const CGObjectInstance *> visitableObjs;
 	std::set<const CGObjectInstance *> alreadyVisited;
 	std::set<const CGObjectInstance *> reservedObjs; //to be visited by specific hero
 	std::map<HeroPtr, std::set<HeroPtr>> visitedHeroes; //visited this turn //FIXME: this is just bug workaround
+	//guards hero reservations, visits and teleport channels which goals read from worker threads while net events change them
+	mutable boost::mutex heroMemoryMutex;
 
 	AIStatus status;
 	std::string battlename;
@@ -115,6 +123,14 @@ public:
 	ObjectInstanceID selectedObject;
 
 	AIhelper * ah;
+	DangerMap dangerMap;
+	FogMap fogMap;
+	TurnBudget turnBudget;
+
+	/// Fuzzy engines are not thread-safe, every thread working for this AI has its own helper
+	std::unique_ptr<FuzzyHelper> fuzzyHelper;
+	std::vector<std::unique_ptr<FuzzyHelper>> workerFuzzyHelpers; //only accessed from makingTurn thread
+	std::unique_ptr<WorkerPool> workerPool; //created by makingTurn thread, must be destroyed before fuzzy helpers of workers
 
 	VCAI();
 	virtual ~VCAI();
@@ -198,6 +214,9 @@ public:
 
 	void makeTurn();
 	void mainLoop();
+	/// Runs independent tasks on worker threads when called from makingTurn thread, otherwise one by one.
+	/// Exception thrown by the first failed task is rethrown after all tasks finished.
+	void executeTasks(std::vector<std::function<void()>> & tasks);
 	void performTypicalActions();
 
 	void buildArmyIn(const CGTownInstance * t);
@@ -209,6 +228,17 @@ public:
 	void evaluateGoal(HeroPtr h); //evaluates goal assigned to hero, if any
 	void completeGoal(Goals::TSubgoal goal); //safely removes goal from reserved hero
 
+	struct BasicGoalDecomposition
+	{
+		Goals::TSubgoal elementarGoal;
+		Goals::TSubgoal ultimateGoal; //last abstract goal elementarGoal was found for
+		Goals::TGoalVec abstractGoals; //to be added to basicGoals
+		Goals::TGoalVec failedGoals; //to be removed from basicGoals
+		Goals::TGoalVec completedGoals;
+	};
+	/// Part of mainLoop, does not modify goals of AI so it can be run for many basic goals in parallel
+	BasicGoalDecomposition decomposeBasicGoal(Goals::TSubgoal basicGoal);
+
 	void recruitHero(const CGTownInstance * t, bool throwing = false);
 	bool isGoodForVisit(const CGObjectInstance * obj, HeroPtr h, boost::optional<float> movementCostLimit = boost::none);
 	bool isGoodForVisit(const CGObjectInstance * obj, HeroPtr h, const AIPath & path) const;
@@ -230,11 +260,17 @@ public:
 	void markObjectVisited(const CGObjectInstance * obj);
 	void reserveObject(HeroPtr h, const CGObjectInstance * obj); //TODO: reserve all objects that heroes attempt to visit
 	void unreserveObject(HeroPtr h, const CGObjectInstance * obj);
+	std::set<const CGObjectInstance *> getReservedObjects(HeroPtr h) const;
+	bool isObjectReserved(const CGObjectInstance * obj) const;
+	bool isReservedByOtherHero(HeroPtr h, const CGObjectInstance * obj) const;
+	bool hasVisitedTownThisWeek(HeroPtr h, const CGTownInstance * t) const;
+	bool hasVisitedHero(HeroPtr visitor, HeroPtr visited) const;
+	boost::optional<TeleportChannel> getKnownTeleportChannel(TeleportChannelID channel) const; //copy, as channels get extended by net events
 
 	void markHeroUnableToExplore(HeroPtr h);
 	void markHeroAbleToExplore(HeroPtr h);
 	bool isAbleToExplore(HeroPtr h);
-	void clearPathsInfo();
+	void clearPathsInfo(const std::unordered_set<int3, ShashInt3> & changedTiles);
 
 	void validateObject(const CGObjectInstance * obj); //checks if object is still visible and if not, removes references to it
 	void validateObject(ObjectIdRef obj); //checks if object is still visible and if not, removes references to it
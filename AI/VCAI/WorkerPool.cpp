@@ -0,0 +1,111 @@
+/*
+* WorkerPool.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#include "StdInc.h"
+#include "WorkerPool.h"
+
+#include "../../lib/CThreadHelper.h"
+
+WorkerPool::WorkerPool(size_t threadsCount, TThreadWrapper threadWrapper)
+	: threadsCount(threadsCount), tasks(nullptr), nextTask(0), unfinishedTasks(0), stopping(false)
+{
+	for(size_t i = 0; i < threadsCount; i++)
+	{
+		threads.create_thread([this, i, threadWrapper]()
+		{
+			setThreadName("VCAI::worker");
+			threadWrapper(i, [this]()
+			{
+				workerLoop();
+			});
+		});
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		stopping = true;
+	}
+	tasksAvailable.notify_all();
+	threads.join_all();
+}
+
+size_t WorkerPool::size() const
+{
+	return threadsCount;
+}
+
+void WorkerPool::run(std::vector<Task> & batch)
+{
+	if(batch.empty())
+		return;
+
+	std::vector<std::exception_ptr> batchErrors;
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		tasks = &batch;
+		errors.assign(batch.size(), nullptr);
+		nextTask = 0;
+		unfinishedTasks = batch.size();
+		tasksAvailable.notify_all();
+
+		{
+			//workers reference tasks of the caller, so they have to finish even if this thread is interrupted
+			boost::this_thread::disable_interruption noInterruption;
+			while(unfinishedTasks)
+				tasksFinished.wait(lock);
+		}
+
+		tasks = nullptr;
+		batchErrors.swap(errors);
+	}
+	boost::this_thread::interruption_point();
+
+	for(auto & error : batchErrors)
+	{
+		if(error)
+			std::rethrow_exception(error);
+	}
+}
+
+void WorkerPool::workerLoop()
+{
+	boost::this_thread::disable_interruption noInterruption;
+	boost::unique_lock<boost::mutex> lock(mx);
+
+	while(true)
+	{
+		while(!stopping && (!tasks || nextTask >= tasks->size()))
+			tasksAvailable.wait(lock);
+
+		if(stopping)
+			return;
+
+		std::vector<Task> & batch = *tasks;
+		const size_t task = nextTask++;
+		std::exception_ptr error;
+
+		lock.unlock();
+		try
+		{
+			batch[task]();
+		}
+		catch(...)
+		{
+			error = std::current_exception();
+		}
+		lock.lock();
+
+		errors[task] = error;
+		if(--unfinishedTasks == 0)
+			tasksFinished.notify_all();
+	}
+}
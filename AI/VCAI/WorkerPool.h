@@ -0,0 +1,46 @@
+/*
+* WorkerPool.h, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#pragma once
+
+/// Threads kept alive for the whole game which run independent tasks of the AI turn,
+/// so every decomposition pass does not pay for starting new threads
+class WorkerPool : public boost::noncopyable
+{
+public:
+	typedef std::function<void()> Task;
+	/// Runs on every worker thread, has to call loop once the thread state is set up
+	typedef std::function<void(size_t worker, const std::function<void()> & loop)> TThreadWrapper;
+
+	WorkerPool(size_t threadsCount, TThreadWrapper threadWrapper);
+	/// Stops and joins all workers, there must be no batch running
+	~WorkerPool();
+
+	size_t size() const;
+
+	/// Runs tasks on workers and waits till all of them are finished.
+	/// Rethrows the first exception in order of tasks. Not reentrant, only one thread may use the pool.
+	void run(std::vector<Task> & tasks);
+
+private:
+	void workerLoop();
+
+	boost::thread_group threads;
+	size_t threadsCount;
+
+	boost::mutex mx;
+	boost::condition_variable tasksAvailable;
+	boost::condition_variable tasksFinished;
+
+	std::vector<Task> * tasks;
+	std::vector<std::exception_ptr> errors;
+	size_t nextTask;
+	size_t unfinishedTasks;
+	bool stopping;
+};
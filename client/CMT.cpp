@@ -54,6 +54,7 @@
 #include "../lib/logging/CBasicLogConfigurator.h"
 #include "../lib/StringConstants.h"
 #include "../lib/CPlayerState.h"
+#include "../lib/CTurnMetrics.h"
 #include "gui/CAnimation.h"
 #include "../lib/serializer/Connection.h"
 #include "CServerHandler.h"
@@ -180,6 +181,9 @@ int main(int argc, char * argv[])
 		("enable-shm-uuid", "use UUID for shared memory identifier")
 		("testmap", po::value<std::string>(), "")
 		("testsave", po::value<std::string>(), "")
+		("testdays", po::value<si64>(), "end test game after given number of days")
+		("testseed", po::value<si64>(), "random seed of new test game, map generated by vcmirmg can be used for random maps")
+		("metrics", po::value<std::string>(), "save per-turn timings of AI players to given JSON file when client quits")
 		("spectate,s", "enable spectator interface for AI-only games")
 		("spectate-ignore-hero", "wont follow heroes on adventure map")
 		("spectate-hero-speed", po::value<int>(), "hero movement speed on adventure map")
@@ -289,6 +293,11 @@ int main(int argc, char * argv[])
 	// Init special testing settings
 	setSettingInteger("session/serverport", "serverport", 0);
 	setSettingString("session/saveprefix", "saveprefix", "");
+	setSettingInteger("session/testdays", "testdays", 0);
+	setSettingInteger("session/testseed", "testseed", 0);
+	setSettingString("session/metrics", "metrics", "");
+	if(!settings["session"]["metrics"].String().empty())
+		turnMetrics.enable();
 	setSettingInteger("general/saveFrequency", "savefrequency", 1);
 
 	// Initialize logging based on settings
@@ -1358,6 +1367,18 @@ void handleQuit(bool ask)
 		if(CSH->client)
 			CSH->endGameplay();
 
+		if(turnMetrics.isEnabled())
+		{
+			try
+			{
+				turnMetrics.saveJson(settings["session"]["metrics"].String());
+			}
+			catch(std::exception & e)
+			{
+				logGlobal->error("Failed to save turn metrics: %s", e.what());
+			}
+		}
+
 		GH.listInt.clear();
 		GH.objsToBlit.clear();
 
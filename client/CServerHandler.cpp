@@ -671,6 +671,8 @@ void CServerHandler::threadRunServer()
 		+ " --port=" + getDefaultPortStr()
 		+ " --run-by-client"
 		+ " --uuid=" + uuid;
+	if(settings["session"]["testseed"].Integer())
+		comm += " --seed=" + std::to_string(settings["session"]["testseed"].Integer());
 	if(shm)
 	{
 		comm += " --enable-shm";
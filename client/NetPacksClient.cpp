@@ -292,6 +292,11 @@ void HeroVisit::applyCl(CClient * cl)
 void NewTurn::applyCl(CClient *cl)
 {
 	cl->invalidatePaths();
+
+	// In auto testing mode client is closed after requested number of days
+	const si64 testDays = settings["session"]["testdays"].Integer();
+	if(!settings["session"]["testmap"].isNull() && testDays && GS(cl)->day > testDays)
+		handleQuit(false);
 }
 
 void GiveBonus::applyCl(CClient *cl)
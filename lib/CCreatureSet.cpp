@@ -215,10 +215,18 @@ bool CCreatureSet::needsLastStack() const
 
 ui64 CCreatureSet::getArmyStrength() const
 {
-	ui64 ret = 0;
-	for(auto & elem : stacks)
-		ret += elem.second->getPower();
-	return ret;
+	const ui32 version = armyVersion;
+
+	if(cachedStrengthVersion != version)
+	{
+		ui64 ret = 0;
+		for(auto & elem : stacks)
+			ret += elem.second->getPower();
+
+		cachedStrength = ret;
+		cachedStrengthVersion = version;
+	}
+	return cachedStrength;
 }
 
 ui64 CCreatureSet::getPower (SlotID slot) const
@@ -276,6 +284,7 @@ void CCreatureSet::setStackCount(SlotID slot, TQuantity count)
 	if (VLC->modh->modules.STACK_EXP && count > stacks[slot]->count)
 		stacks[slot]->experience *= (count / static_cast<double>(stacks[slot]->count));
 	stacks[slot]->count = count;
+	stacksChanged();
 	armyChanged();
 }
 
@@ -357,6 +366,7 @@ void CCreatureSet::putStack(SlotID slot, CStackInstance *stack)
 	assert(!hasStackAtSlot(slot));
 	stacks[slot] = stack;
 	stack->setArmyObj(castToArmyObj());
+	stacksChanged();
 	armyChanged();
 }
 
@@ -378,6 +388,7 @@ void CCreatureSet::changeStackCount(SlotID slot, TQuantity toAdd)
 }
 
 CCreatureSet::CCreatureSet()
+	: armyVersion(1), cachedStrengthVersion(0), cachedStrength(0)
 {
 	formation = false;
 }
@@ -417,6 +428,7 @@ CStackInstance * CCreatureSet::detachStack(SlotID slot)
 	}
 
 	stacks.erase(slot);
+	stacksChanged();
 	armyChanged();
 	return ret;
 }
@@ -426,6 +438,7 @@ void CCreatureSet::setStackType(SlotID slot, CreatureID type)
 	assert(hasStackAtSlot(slot));
 	CStackInstance *s = stacks[slot];
 	s->setType(type);
+	stacksChanged();
 	armyChanged();
 }
 
@@ -480,6 +493,16 @@ void CCreatureSet::armyChanged()
 
 }
 
+void CCreatureSet::stacksChanged()
+{
+	armyVersion++;
+}
+
+ui32 CCreatureSet::getArmyVersion() const
+{
+	return armyVersion;
+}
+
 void CCreatureSet::serializeJson(JsonSerializeFormat & handler, const std::string & fieldName, const boost::optional<int> fixedSize)
 {
 	if(handler.saving && stacks.empty())
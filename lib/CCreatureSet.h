@@ -163,6 +163,13 @@ class DLL_LINKAGE CCreatureSet : public IArmyDescriptor //seven combined creatur
 {
 	CCreatureSet(const CCreatureSet&);
 	CCreatureSet &operator=(const CCreatureSet&);
+
+	ui32 armyVersion; //changed on every modification of stacks, not serialized
+	mutable std::atomic<ui32> cachedStrengthVersion;
+	mutable std::atomic<ui64> cachedStrength;
+
+protected:
+	void stacksChanged(); //has to be called when stacks were modified without using basic operations below
 public:
 	TSlots stacks; //slots[slot_id]->> pair(creature_id,creature_quantity)
 	ui8 formation; //false - wide, true - tight
@@ -170,6 +177,7 @@ public:
 	CCreatureSet();
 	virtual ~CCreatureSet();
 	virtual void armyChanged();
+	ui32 getArmyVersion() const; //army with same version has same stacks
 
 	const CStackInstance &operator[](SlotID slot) const;
 
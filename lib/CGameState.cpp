@@ -668,6 +668,73 @@ int CGameState::getDate(Date::EDateType mode) const
 	return 0;
 }
 
+namespace
+{
+	/// Feeds value to crc in little endian order so hash does not depend on host endianness
+	void hashValue(boost::crc_32_type & crc, si64 value)
+	{
+		ui8 bytes[8];
+		for(int i = 0; i < 8; i++)
+			bytes[i] = static_cast<ui8>(static_cast<ui64>(value) >> (i * 8));
+		crc.process_bytes(bytes, sizeof(bytes));
+	}
+}
+
+ui32 CGameState::calculateStateHash() const
+{
+	boost::crc_32_type crc;
+	hashValue(crc, day);
+
+	for(auto & elem : players)
+	{
+		hashValue(crc, elem.first.getNum());
+		hashValue(crc, elem.second.status);
+		for(int amount : elem.second.resources)
+			hashValue(crc, amount);
+	}
+
+	for(const CGObjectInstance * obj : map->objects)
+	{
+		if(!obj)
+			continue;
+
+		hashValue(crc, obj->id.getNum());
+		hashValue(crc, obj->ID.num);
+		hashValue(crc, obj->subID);
+		hashValue(crc, obj->tempOwner.getNum());
+
+		if(auto army = dynamic_cast<const CArmedInstance *>(obj))
+		{
+			for(auto & slot : army->Slots())
+			{
+				hashValue(crc, slot.first.getNum());
+				hashValue(crc, slot.second->getCreatureID().num);
+				hashValue(crc, slot.second->count);
+			}
+		}
+
+		if(auto hero = dynamic_cast<const CGHeroInstance *>(obj))
+		{
+			hashValue(crc, hero->pos.x);
+			hashValue(crc, hero->pos.y);
+			hashValue(crc, hero->pos.z);
+			hashValue(crc, hero->exp);
+			hashValue(crc, hero->level);
+			hashValue(crc, hero->mana);
+			hashValue(crc, hero->movement);
+			for(int i = 0; i < GameConstants::PRIMARY_SKILLS; i++)
+				hashValue(crc, hero->getPrimSkillLevel(static_cast<PrimarySkill::PrimarySkill>(i)));
+			for(auto & skill : hero->secSkills)
+			{
+				hashValue(crc, skill.first.num);
+				hashValue(crc, skill.second);
+			}
+		}
+	}
+
+	return crc.checksum();
+}
+
 CGameState::CGameState()
 {
 	gs = this;
@@ -1514,18 +1581,8 @@ void CGameState::initFogOfWar()
 	logGlobal->debug("\tFog of war"); //FIXME: should be initialized after all bonuses are set
 	for(auto & elem : teams)
 	{
-		elem.second.fogOfWarMap.resize(map->width);
-		for(int g=0; g<map->width; ++g)
-			elem.second.fogOfWarMap[g].resize(map->height);
-
-		for(int g=-0; g<map->width; ++g)
-			for(int h=0; h<map->height; ++h)
-				elem.second.fogOfWarMap[g][h].resize(map->twoLevel ? 2 : 1, 0);
-
-		for(int g=0; g<map->width; ++g)
-			for(int h=0; h<map->height; ++h)
-				for(int v = 0; v < (map->twoLevel ? 2 : 1); ++v)
-					elem.second.fogOfWarMap[g][h][v] = 0;
+		elem.second.fogOfWarMap.resize(boost::extents[map->width][map->height][map->twoLevel ? 2 : 1]);
+		std::fill_n(elem.second.fogOfWarMap.data(), elem.second.fogOfWarMap.num_elements(), 0);
 
 		for(CGObjectInstance *obj : map->objects)
 		{
@@ -3086,7 +3143,9 @@ TeamState::TeamState(TeamState && other):
 	id(other.id)
 {
 	std::swap(players, other.players);
-	std::swap(fogOfWarMap, other.fogOfWarMap);
+	// multi_array assignment requires equal shapes
+	fogOfWarMap.resize(boost::extents[other.fogOfWarMap.shape()[0]][other.fogOfWarMap.shape()[1]][other.fogOfWarMap.shape()[2]]);
+	fogOfWarMap = other.fogOfWarMap;
 }
 
 CRandomGenerator & CGameState::getRandomGenerator()
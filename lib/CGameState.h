@@ -197,6 +197,9 @@ public:
 	bool isVisible(const CGObjectInstance *obj, boost::optional<PlayerColor> player);
 
 	int getDate(Date::EDateType mode=Date::DAY) const; //mode=0 - total days in game, mode=1 - day of week, mode=2 - current week, mode=3 - current month
+	/// Digest of the state most prone to desyncs: resources, heroes, armies and object owners.
+	/// Platform-independent, so server and clients can compare their values directly
+	ui32 calculateStateHash() const;
 
 	// ----- getters, setters -----
 
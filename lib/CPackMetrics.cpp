@@ -0,0 +1,178 @@
+/*
+ * CPackMetrics.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CPackMetrics.h"
+
+#include "NetPacksBase.h"
+#include "filesystem/FileStream.h"
+#include "serializer/CTypeList.h"
+
+CDurationHistogram::CDurationHistogram()
+	: count(0), total(0), max(0)
+{
+	buckets.fill(0);
+}
+
+void CDurationHistogram::add(ui64 micros)
+{
+	int bucket = 0;
+	while(bucket < BUCKETS - 1 && (1ull << bucket) <= micros)
+		bucket++;
+
+	buckets[bucket]++;
+	count++;
+	total += micros;
+	vstd::amax(max, micros);
+}
+
+ui64 CDurationHistogram::getPercentile(double fraction) const
+{
+	const ui64 wanted = std::ceil(count * fraction);
+	ui64 seen = 0;
+	for(int bucket = 0; bucket < BUCKETS; bucket++)
+	{
+		seen += buckets[bucket];
+		if(seen >= wanted && seen > 0)
+			return std::min<ui64>(max, bucket ? (1ull << bucket) - 1 : 0);
+	}
+	return max;
+}
+
+JsonNode CDurationHistogram::toJson() const
+{
+	JsonNode ret;
+	ret["count"].Integer() = count;
+	ret["total"].Integer() = total;
+	ret["max"].Integer() = max;
+	ret["p50"].Integer() = getPercentile(0.5);
+	ret["p90"].Integer() = getPercentile(0.9);
+	ret["p99"].Integer() = getPercentile(0.99);
+
+	//trailing empty buckets are omitted, bucket N counts samples below 2^N microseconds
+	int used = BUCKETS;
+	while(used > 0 && buckets[used - 1] == 0)
+		used--;
+	for(int bucket = 0; bucket < used; bucket++)
+	{
+		JsonNode value;
+		value.Integer() = buckets[bucket];
+		ret["buckets"].Vector().push_back(value);
+	}
+	return ret;
+}
+
+CPackMetrics::PackStats::PackStats()
+	: received(0), sent(0), bytesSent(0)
+{
+}
+
+JsonNode CPackMetrics::PackStats::toJson() const
+{
+	JsonNode ret;
+	ret["name"].String() = name;
+	ret["received"].Integer() = received;
+	ret["sent"].Integer() = sent;
+	ret["bytesSent"].Integer() = bytesSent;
+	ret["latency"] = latency.toJson();
+	ret["applyTime"] = applyTime.toJson();
+	return ret;
+}
+
+ui64 CPackMetrics::microsecondsSince(TClock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(TClock::now() - start).count();
+}
+
+CPackMetrics::PackStats & CPackMetrics::getStatsFor(const CPack * pack)
+{
+	PackStats & ret = stats[typeList.getTypeID(pack)];
+	if(ret.name.empty())
+		ret.name = typeList.getTypeName(pack);
+	return ret;
+}
+
+void CPackMetrics::addReceived(const CPack * pack, ui64 latencyMicros, ui64 applyMicros)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	PackStats & packStats = getStatsFor(pack);
+	packStats.received++;
+	packStats.latency.add(latencyMicros);
+	packStats.applyTime.add(applyMicros);
+}
+
+void CPackMetrics::addSent(const CPack * pack, ui64 bytes)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	PackStats & packStats = getStatsFor(pack);
+	packStats.sent++;
+	packStats.bytesSent += bytes;
+}
+
+void CPackMetrics::addApplied(const CPack * pack, ui64 applyMicros)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	getStatsFor(pack).applyTime.add(applyMicros);
+}
+
+std::map<ui16, CPackMetrics::PackStats> CPackMetrics::getStats() const
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	return stats;
+}
+
+void CPackMetrics::reset()
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	stats.clear();
+}
+
+std::string CPackMetrics::toString() const
+{
+	auto copy = getStats();
+
+	std::vector<const PackStats *> sorted;
+	for(auto & elem : copy)
+		sorted.push_back(&elem.second);
+	boost::sort(sorted, [](const PackStats * a, const PackStats * b)
+	{
+		return a->applyTime.getTotal() > b->applyTime.getTotal();
+	});
+
+	std::ostringstream out;
+	out << boost::format("%-40s %8s %8s %10s %10s %8s %8s %8s\n")
+		% "Pack" % "Recv" % "Sent" % "Bytes" % "Apply,ms" % "p50,us" % "p99,us" % "Lat99,us";
+	for(const PackStats * packStats : sorted)
+	{
+		out << boost::format("%-40s %8d %8d %10d %10d %8d %8d %8d\n")
+			% packStats->name
+			% packStats->received
+			% packStats->sent
+			% packStats->bytesSent
+			% (packStats->applyTime.getTotal() / 1000)
+			% packStats->applyTime.getPercentile(0.5)
+			% packStats->applyTime.getPercentile(0.99)
+			% packStats->latency.getPercentile(0.99);
+	}
+	return out.str();
+}
+
+JsonNode CPackMetrics::toJson() const
+{
+	JsonNode ret;
+	for(auto & elem : getStats())
+		ret["packs"].Vector().push_back(elem.second.toJson());
+	return ret;
+}
+
+void CPackMetrics::saveJson(const boost::filesystem::path & fname) const
+{
+	FileStream file(fname, std::ofstream::out | std::ofstream::trunc);
+	file << toJson().toJson();
+}
@@ -0,0 +1,83 @@
+/*
+ * CPackMetrics.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include "JsonNode.h"
+
+struct CPack;
+
+/// Histogram of durations in microseconds with power of two buckets
+class DLL_LINKAGE CDurationHistogram
+{
+public:
+	static const int BUCKETS = 32;
+
+	CDurationHistogram();
+
+	void add(ui64 micros);
+
+	ui64 getCount() const { return count; }
+	ui64 getTotal() const { return total; }
+	ui64 getMax() const { return max; }
+	/// Upper bound of bucket that contains given percentile (0..1) of samples
+	ui64 getPercentile(double fraction) const;
+
+	JsonNode toJson() const;
+
+private:
+	std::array<ui64, BUCKETS> buckets;
+	ui64 count;
+	ui64 total;
+	ui64 max;
+};
+
+/// Counters and timings of packs handled by server, keyed by CTypeList id of pack.
+/// Thread safe, packs are received by connection threads while game handler sends its own
+class DLL_LINKAGE CPackMetrics : public boost::noncopyable
+{
+public:
+	typedef std::chrono::steady_clock TClock;
+
+	struct DLL_LINKAGE PackStats
+	{
+		std::string name;
+		ui64 received;
+		ui64 sent;
+		ui64 bytesSent; //summed over all connections
+		CDurationHistogram latency; //from receiving pack to confirming it to client
+		CDurationHistogram applyTime; //applyGh for received packs, gs->apply for sent ones
+
+		PackStats();
+		JsonNode toJson() const;
+	};
+
+	static ui64 microsecondsSince(TClock::time_point start);
+
+	void addReceived(const CPack * pack, ui64 latencyMicros, ui64 applyMicros);
+	void addSent(const CPack * pack, ui64 bytes);
+	void addApplied(const CPack * pack, ui64 applyMicros);
+
+	std::map<ui16, PackStats> getStats() const;
+	void reset();
+
+	/// Table sorted by total apply time, most expensive types first
+	std::string toString() const;
+	JsonNode toJson() const;
+	void saveJson(const boost::filesystem::path & fname) const;
+
+private:
+	PackStats & getStatsFor(const CPack * pack); //mx must be locked
+
+	mutable boost::mutex mx;
+	std::map<ui16, PackStats> stats;
+};
@@ -872,7 +872,7 @@ bool CPathfinder::isSourceGuarded() const
 	/// - Map start with hero on guarded tile
 	/// - Dimention door used
 	/// TODO: check what happen when there is several guards
-	if(gs->guardingCreaturePosition(source.node->coord).valid() && !isSourceInitialPosition())
+	if(gs->map->isTileGuarded(source.node->coord) && !isSourceInitialPosition())
 	{
 		return true;
 	}
@@ -884,7 +884,7 @@ bool CPathfinder::isDestinationGuarded() const
 {
 	/// isDestinationGuarded is exception needed for garrisons.
 	/// When monster standing behind garrison it's visitable and guarded at the same time.
-	return gs->guardingCreaturePosition(destination.node->coord).valid();
+	return gs->map->isTileGuarded(destination.node->coord);
 }
 
 bool CPathfinder::isDestinationGuardian() const
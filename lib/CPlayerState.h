@@ -72,8 +72,8 @@ struct DLL_LINKAGE TeamState : public CBonusSystemNode
 public:
 	TeamID id; //position in gameState::teams
 	std::set<PlayerColor> players; // members of this team
-	//TODO: boost::array, bool if possible
-	std::vector<std::vector<std::vector<ui8> > >  fogOfWarMap; //true - visible, false - hidden
+	/// tiles of the map in a single buffer, access is as follows: x, y, level
+	boost::multi_array<ui8, 3> fogOfWarMap; //true - visible, false - hidden
 
 	TeamState();
 	TeamState(TeamState && other);
@@ -82,7 +82,20 @@ public:
 	{
 		h & id;
 		h & players;
-		h & fogOfWarMap;
+		if(version >= 792)
+		{
+			h & fogOfWarMap;
+		}
+		else
+		{
+			std::vector<std::vector<std::vector<ui8> > > fogOfWarGrid;
+			h & fogOfWarGrid;
+			const size_t levels = fogOfWarGrid.empty() || fogOfWarGrid.front().empty() ? 0 : fogOfWarGrid.front().front().size();
+			fogOfWarMap.resize(boost::extents[fogOfWarGrid.size()][fogOfWarGrid.empty() ? 0 : fogOfWarGrid.front().size()][levels]);
+			for(size_t x = 0; x < fogOfWarGrid.size(); x++)
+				for(size_t y = 0; y < fogOfWarGrid[x].size(); y++)
+					std::copy(fogOfWarGrid[x][y].begin(), fogOfWarGrid[x][y].end(), &fogOfWarMap[x][y][0]);
+		}
 		h & static_cast<CBonusSystemNode&>(*this);
 	}
 
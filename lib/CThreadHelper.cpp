@@ -31,6 +31,39 @@ void CThreadHelper::run()
 
 	//thread group deletes threads, do not free manually
 }
+void CThreadHelper::runTasks(std::vector<Task> & tasks, int threads)
+{
+	if(threads <= 0)
+		threads = boost::thread::hardware_concurrency();
+	threads = std::max(1, std::min<int>(threads, tasks.size()));
+
+	std::vector<std::exception_ptr> errors(tasks.size());
+	std::vector<Task> guardedTasks;
+	for(size_t i = 0; i < tasks.size(); i++)
+	{
+		guardedTasks.push_back([&tasks, &errors, i]()
+		{
+			try
+			{
+				tasks[i]();
+			}
+			catch(...)
+			{
+				errors[i] = std::current_exception();
+			}
+		});
+	}
+
+	CThreadHelper helper(&guardedTasks, threads);
+	helper.run();
+
+	for(auto & error : errors)
+	{
+		if(error)
+			std::rethrow_exception(error);
+	}
+}
+
 void CThreadHelper::processTasks()
 {
 	while(true)
@@ -24,6 +24,10 @@ class DLL_LINKAGE CThreadHelper
 public:
 	CThreadHelper(std::vector<std::function<void()> > *Tasks, int Threads);
 	void run();
+
+	/// Runs tasks on given number of threads, 0 - one per core. Rethrows the first exception thrown by a task
+	/// once all tasks are finished
+	static void runTasks(std::vector<Task> & tasks, int threads);
 };
 
 template <typename T> inline void setData(T * data, std::function<T()> func)
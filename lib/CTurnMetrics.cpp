@@ -0,0 +1,176 @@
+/*
+ * CTurnMetrics.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CTurnMetrics.h"
+
+#include "HeroBonus.h"
+#include "filesystem/FileStream.h"
+
+#ifdef VCMI_UNIX
+#include <sys/resource.h>
+#endif
+
+CTurnMetrics turnMetrics;
+
+CTurnMetrics::TurnRecord::TurnRecord()
+	: day(0), turnTime(0), pathfindingTime(0), pathfindingCount(0), bonusCacheHits(0), bonusCacheMisses(0), peakMemory(0)
+{
+}
+
+JsonNode CTurnMetrics::TurnRecord::toJson() const
+{
+	JsonNode ret;
+	ret["player"].String() = player.getStr();
+	ret["day"].Integer() = day;
+	ret["turnTime"].Integer() = turnTime;
+	ret["pathfindingTime"].Integer() = pathfindingTime;
+	ret["pathfindingCount"].Integer() = pathfindingCount;
+	ret["bonusCacheHits"].Integer() = bonusCacheHits;
+	ret["bonusCacheMisses"].Integer() = bonusCacheMisses;
+	ret["peakMemory"].Integer() = peakMemory;
+	return ret;
+}
+
+CTurnMetrics::CTurnMetrics()
+	: enabled(false)
+{
+}
+
+void CTurnMetrics::enable()
+{
+	enabled = true;
+}
+
+bool CTurnMetrics::isEnabled() const
+{
+	return enabled;
+}
+
+void CTurnMetrics::startTurn(PlayerColor player, si32 day)
+{
+	if(!enabled)
+		return;
+
+	boost::unique_lock<boost::mutex> lock(mx);
+
+	ActiveTurn & turn = activeTurns[player];
+	turn.record = TurnRecord();
+	turn.record.player = player;
+	turn.record.day = day;
+	turn.record.bonusCacheHits = CBonusSystemNode::getCacheHits();
+	turn.record.bonusCacheMisses = CBonusSystemNode::getCacheMisses();
+	turn.start = TClock::now();
+}
+
+void CTurnMetrics::endTurn(PlayerColor player)
+{
+	if(!enabled)
+		return;
+
+	boost::unique_lock<boost::mutex> lock(mx);
+
+	auto it = activeTurns.find(player);
+	if(it == activeTurns.end())
+		return;
+
+	TurnRecord record = it->second.record;
+	record.turnTime = CPackMetrics::microsecondsSince(it->second.start);
+	record.bonusCacheHits = CBonusSystemNode::getCacheHits() - record.bonusCacheHits;
+	record.bonusCacheMisses = CBonusSystemNode::getCacheMisses() - record.bonusCacheMisses;
+	record.peakMemory = getPeakMemory();
+
+	turns.push_back(record);
+	activeTurns.erase(it);
+}
+
+void CTurnMetrics::addPathfinding(PlayerColor player, TClock::time_point start)
+{
+	if(!enabled)
+		return;
+
+	const ui64 duration = CPackMetrics::microsecondsSince(start);
+
+	boost::unique_lock<boost::mutex> lock(mx);
+
+	auto it = activeTurns.find(player);
+	if(it == activeTurns.end())
+		return; //paths calculated outside of the turn, e.g. when answering queries
+
+	it->second.record.pathfindingTime += duration;
+	it->second.record.pathfindingCount++;
+}
+
+std::vector<CTurnMetrics::TurnRecord> CTurnMetrics::getTurns() const
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	return turns;
+}
+
+JsonNode CTurnMetrics::toJson() const
+{
+	struct PlayerSummary
+	{
+		CDurationHistogram turnTime;
+		ui64 pathfindingTime = 0;
+		ui64 bonusCacheHits = 0;
+		ui64 bonusCacheMisses = 0;
+	};
+
+	JsonNode ret;
+	std::map<PlayerColor, PlayerSummary> summaries;
+	JsonNode turnsNode(JsonNode::JsonType::DATA_VECTOR);
+
+	for(const TurnRecord & record : getTurns())
+	{
+		PlayerSummary & summary = summaries[record.player];
+		summary.turnTime.add(record.turnTime);
+		summary.pathfindingTime += record.pathfindingTime;
+		summary.bonusCacheHits += record.bonusCacheHits;
+		summary.bonusCacheMisses += record.bonusCacheMisses;
+
+		turnsNode.Vector().push_back(record.toJson());
+	}
+
+	for(auto & summary : summaries)
+	{
+		JsonNode & node = ret["players"][summary.first.getStr()];
+		const ui64 bonusRequests = summary.second.bonusCacheHits + summary.second.bonusCacheMisses;
+
+		node["turnTime"] = summary.second.turnTime.toJson();
+		node["pathfindingTime"].Integer() = summary.second.pathfindingTime;
+		node["bonusCacheHitRate"].Float() = bonusRequests ? (double)summary.second.bonusCacheHits / bonusRequests : 0;
+	}
+
+	ret["turns"] = turnsNode;
+	ret["peakMemory"].Integer() = getPeakMemory();
+	return ret;
+}
+
+void CTurnMetrics::saveJson(const boost::filesystem::path & fname) const
+{
+	FileStream file(fname, std::ofstream::out | std::ofstream::trunc);
+	file << toJson().toJson();
+}
+
+ui64 CTurnMetrics::getPeakMemory()
+{
+#ifdef VCMI_UNIX
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+#ifdef VCMI_APPLE
+		return usage.ru_maxrss / 1024; //reported in bytes
+#else
+		return usage.ru_maxrss;
+#endif
+	}
+#endif
+	return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * CTurnMetrics.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "CPackMetrics.h"
+#include "GameConstants.h"
+
+/// Timings of player turns, recorded by AI when enabled. Used by AI self-play tests
+/// (vcmiclient --headless --testmap ... --metrics <file>) to track AI turn time regressions.
+/// Thread safe, pathfinding may be reported from worker threads of the AI
+class DLL_LINKAGE CTurnMetrics : public boost::noncopyable
+{
+public:
+	typedef CPackMetrics::TClock TClock;
+
+	struct DLL_LINKAGE TurnRecord
+	{
+		PlayerColor player;
+		si32 day;
+		ui64 turnTime; //microseconds
+		ui64 pathfindingTime; //microseconds, summed over all threads
+		ui64 pathfindingCount;
+		ui64 bonusCacheHits; //bonus system is shared, includes requests of other threads during the turn
+		ui64 bonusCacheMisses;
+		ui64 peakMemory; //kilobytes, process high-water mark at the end of turn
+
+		TurnRecord();
+		JsonNode toJson() const;
+	};
+
+	CTurnMetrics();
+
+	void enable();
+	bool isEnabled() const;
+
+	void startTurn(PlayerColor player, si32 day);
+	void endTurn(PlayerColor player);
+	void addPathfinding(PlayerColor player, TClock::time_point start);
+
+	std::vector<TurnRecord> getTurns() const;
+
+	/// Turn list and per player summary
+	JsonNode toJson() const;
+	void saveJson(const boost::filesystem::path & fname) const;
+
+	/// Peak resident memory of the process in kilobytes, 0 if not supported on this platform
+	static ui64 getPeakMemory();
+
+private:
+	struct ActiveTurn
+	{
+		TurnRecord record;
+		TClock::time_point start;
+	};
+
+	std::atomic<bool> enabled;
+	mutable boost::mutex mx;
+	std::map<PlayerColor, ActiveTurn> activeTurns;
+	std::vector<TurnRecord> turns;
+};
+
+extern DLL_LINKAGE CTurnMetrics turnMetrics;
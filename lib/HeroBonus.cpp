@@ -23,6 +23,7 @@
 #include "CArtHandler.h"
 #include "StringConstants.h"
 #include "battle/BattleInfo.h"
+#include "CTurnMetrics.h"
 
 #define FOREACH_PARENT(pname) 	TNodes lparents; getParents(lparents); for(CBonusSystemNode *pname : lparents)
 #define FOREACH_CPARENT(pname) 	TCNodes lparents; getParents(lparents); for(const CBonusSystemNode *pname : lparents)
@@ -213,6 +214,8 @@ JsonNode CAddInfo::toJsonNode() const
 }
 
 std::atomic<int32_t> CBonusSystemNode::treeChanged(1);
+std::atomic<int64_t> CBonusSystemNode::cacheHits(0);
+std::atomic<int64_t> CBonusSystemNode::cacheMisses(0);
 const bool CBonusSystemNode::cachingEnabled = true;
 
 BonusList::BonusList(bool BelongsToTree) : belongsToTree(BelongsToTree)
@@ -730,8 +733,13 @@ const TBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, c
 
 		// If the bonus system tree changes(state of a single node or the relations to each other) then
 		// cache all bonus objects. Selector objects doesn't matter.
+		//counters are shared by all threads, so they are updated only while turn metrics are recorded
+		const bool countRequests = turnMetrics.isEnabled();
+
 		if (cachedLast != treeChanged)
 		{
+			if(countRequests)
+				cacheMisses++;
 			cachedBonuses.clear();
 			cachedRequests.clear();
 
@@ -742,6 +750,10 @@ const TBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, c
 
 			cachedLast = treeChanged;
 		}
+		else if(countRequests)
+		{
+			cacheHits++;
+		}
 
 		// If a bonus system request comes with a caching string then look up in the map if there are any
 		// pre-calculated bonus results. Limiters can't be cached so they have to be calculated.
@@ -1215,6 +1227,16 @@ void CBonusSystemNode::treeHasChanged()
 	treeChanged++;
 }
 
+int64_t CBonusSystemNode::getCacheHits()
+{
+	return cacheHits;
+}
+
+int64_t CBonusSystemNode::getCacheMisses()
+{
+	return cacheMisses;
+}
+
 int64_t CBonusSystemNode::getTreeVersion() const
 {
 	int64_t ret = treeChanged;
@@ -701,6 +701,8 @@ private:
 	mutable BonusList cachedBonuses;
 	mutable int64_t cachedLast;
 	static std::atomic<int32_t> treeChanged;
+	static std::atomic<int64_t> cacheHits;
+	static std::atomic<int64_t> cacheMisses;
 
 	// Setting a value to cachingStr before getting any bonuses caches the result for later requests.
 	// This string needs to be unique, that's why it has to be setted in the following manner:
@@ -769,6 +771,10 @@ public:
 	void setDescription(const std::string &description);
 
 	static void treeHasChanged();
+	/// Number of cached bonus requests answered from the cache and those which had to rebuild it,
+	/// counted only while turn metrics are enabled
+	static int64_t getCacheHits();
+	static int64_t getCacheMisses();
 
 	int64_t getTreeVersion() const override;
 
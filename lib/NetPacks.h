@@ -1020,8 +1020,9 @@ struct NewTurn : public CPackForClient
 	ui32 day;
 	ui8 specialWeek; //weekType
 	CreatureID creatureid; //for creature weeks
+	ui32 stateHash; //CGameState::calculateStateHash() of server before applying this pack, 0 - not checked
 
-	NewTurn():day(0),specialWeek(0){};
+	NewTurn():day(0),specialWeek(0),stateHash(0){};
 
 	template <typename Handler> void serialize(Handler &h, const int version)
 	{
@@ -1031,6 +1032,8 @@ struct NewTurn : public CPackForClient
 		h & day;
 		h & specialWeek;
 		h & creatureid;
+		if(version >= 791)
+			h & stateHash;
 	}
 };
 
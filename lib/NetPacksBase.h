@@ -28,6 +28,7 @@ struct ArtSlotInfo;
 struct DLL_LINKAGE CPack
 {
 	std::shared_ptr<CConnection> c; // Pointer to connection that pack received from
+	std::chrono::steady_clock::time_point receivedTime; // When connection received the pack, not serialized
 
 	CPack() : c(nullptr) {};
 	virtual ~CPack() {};
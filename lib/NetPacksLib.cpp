@@ -460,7 +460,6 @@ DLL_LINKAGE void RemoveObject::applyGs(CGameState *gs)
 	}
 	gs->map->instanceNames.erase(obj->instanceName);
 	gs->map->objects[id.getNum()].dellNull();
-	gs->map->calculateGuardingGreaturePositions();
 }
 
 static int getDir(int3 src, int3 dst)
@@ -712,7 +711,6 @@ DLL_LINKAGE void NewObject::applyGs(CGameState *gs)
 	gs->map->objects.push_back(o);
 	gs->map->addBlockVisTiles(o);
 	o->initObj(gs->getRandomGenerator());
-	gs->map->calculateGuardingGreaturePositions();
 
 	logGlobal->debug("Added object id=%d; address=%x; name=%s", id, (intptr_t)o, o->getObjectName());
 }
@@ -1117,6 +1115,13 @@ DLL_LINKAGE void SetAvailableArtifacts::applyGs(CGameState *gs)
 
 DLL_LINKAGE void NewTurn::applyGs(CGameState *gs)
 {
+	if(stateHash)
+	{
+		ui32 localHash = gs->calculateStateHash();
+		if(localHash != stateHash)
+			logGlobal->error("Desync detected before day %d! Game state hash is %x, expected %x", day, localHash, stateHash);
+	}
+
 	gs->day = day;
 
 	// Update bonuses before doing anything else so hero don't get more MP than needed
@@ -14,7 +14,7 @@
 
 namespace PathfinderUtil
 {
-	using FoW = std::vector<std::vector<std::vector<ui8> > >;
+	using FoW = boost::multi_array<ui8, 3>;
 	using ELayer = EPathfindingLayer;
 
 	template<EPathfindingLayer::EEPathfindingLayer layer>
@@ -50,7 +50,7 @@ namespace PathfinderUtil
 			{
 				return CGPathNode::BLOCKED;
 			}
-			else if(gs->guardingCreaturePosition(pos).valid())
+			else if(gs->map->isTileGuarded(pos))
 			{
 				// Monster close by; blocked visit for battle
 				return CGPathNode::BLOCKVIS;
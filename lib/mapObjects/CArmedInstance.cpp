@@ -33,6 +33,7 @@ void CArmedInstance::randomizeArmy(int type)
 		assert(elem.second->valid(false));
 		assert(elem.second->armyObj == this);
 	}
+	stacksChanged();
 	return;
 }
 
@@ -228,7 +228,7 @@ int CGHeroInstance::maxMovePointsCached(bool onLand, const TurnInfo * ti) const
 }
 
 CGHeroInstance::CGHeroInstance()
- : IBoatGenerator(this)
+ : IBoatGenerator(this), cachedFightingStrengthVersion(0), cachedFightingStrength(0)
 {
 	setNodeType(HERO);
 	ID = Obj::HERO;
@@ -581,7 +581,15 @@ TFaction CGHeroInstance::getFaction() const
 
 double CGHeroInstance::getFightingStrength() const
 {
-	return sqrt((1.0 + 0.05*getPrimSkillLevel(PrimarySkill::ATTACK)) * (1.0 + 0.05*getPrimSkillLevel(PrimarySkill::DEFENSE)));
+	//AI compares strengths of armies many times per turn, primary skills change only with bonus tree
+	const int64_t treeVersion = getTreeVersion();
+
+	if(cachedFightingStrengthVersion != treeVersion)
+	{
+		cachedFightingStrength = sqrt((1.0 + 0.05*getPrimSkillLevel(PrimarySkill::ATTACK)) * (1.0 + 0.05*getPrimSkillLevel(PrimarySkill::DEFENSE)));
+		cachedFightingStrengthVersion = treeVersion;
+	}
+	return cachedFightingStrength;
 }
 
 double CGHeroInstance::getMagicStrength() const
@@ -46,6 +46,9 @@ class DLL_LINKAGE CGHeroInstance : public CArmedInstance, public IBoatGenerator,
 private:
 	std::set<SpellID> spells; //known spells (spell IDs)
 
+	mutable std::atomic<int64_t> cachedFightingStrengthVersion; //bonus tree version, not serialized
+	mutable std::atomic<double> cachedFightingStrength;
+
 public:
 	//////////////////////////////////////////////////////////////////////////
 
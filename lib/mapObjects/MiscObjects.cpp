@@ -237,6 +237,7 @@ void CGCreature::initObj(CRandomGenerator & rand)
 			amount = 1;
 		}
 	}
+	stacksChanged();
 
 	temppower = stacks[SlotID(0)]->count * (ui64)1000;
 	refusedJoining = false;
@@ -262,6 +263,7 @@ void CGCreature::setPropertyDer(ui8 what, ui32 val)
 	{
 		case ObjProperty::MONSTER_COUNT:
 			stacks[SlotID(0)]->count = val;
+			stacksChanged();
 			break;
 		case ObjProperty::MONSTER_POWER:
 			temppower = val;
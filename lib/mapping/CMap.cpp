@@ -232,8 +232,7 @@ CMapHeader::~CMapHeader()
 }
 
 CMap::CMap()
-	: checksum(0), grailPos(-1, -1, -1), grailRadius(0), terrain(nullptr),
-	guardingCreaturePositions(nullptr)
+	: checksum(0), grailPos(-1, -1, -1), grailRadius(0)
 {
 	allHeroes.resize(allowedHeroes.size());
 	allowedAbilities = VLC->skillh->getDefaultAllowed();
@@ -243,22 +242,6 @@ CMap::CMap()
 
 CMap::~CMap()
 {
-	if(terrain)
-	{
-		for (int i=0; i<width; i++)
-		{
-			for(int j=0; j<height; j++)
-			{
-				delete [] terrain[i][j];
-				delete [] guardingCreaturePositions[i][j];
-			}
-			delete [] terrain[i];
-			delete [] guardingCreaturePositions[i];
-		}
-		delete [] terrain;
-		delete [] guardingCreaturePositions;
-	}
-
 	for(auto obj : objects)
 		obj.dellNull();
 
@@ -293,6 +276,7 @@ void CMap::removeBlockVisTiles(CGObjectInstance * obj, bool total)
 			}
 		}
 	}
+	updateGuardingCreaturePositions(obj);
 }
 
 void CMap::addBlockVisTiles(CGObjectInstance * obj)
@@ -320,6 +304,7 @@ void CMap::addBlockVisTiles(CGObjectInstance * obj)
 			}
 		}
 	}
+	updateGuardingCreaturePositions(obj);
 }
 
 void CMap::calculateGuardingGreaturePositions()
@@ -330,7 +315,28 @@ void CMap::calculateGuardingGreaturePositions()
 		for(int j=0; j<height; j++)
 		{
 			for (int k = 0; k < levels; k++)
-				guardingCreaturePositions[i][j][k] = guardingCreaturePosition(int3(i,j,k));
+				setGuardingCreaturePosition(int3(i,j,k), guardingCreaturePosition(int3(i,j,k)));
+		}
+	}
+}
+
+void CMap::setGuardingCreaturePosition(const int3 & pos, const int3 & guard)
+{
+	guardingCreaturePositions[pos.x][pos.y][pos.z] = guard;
+	guardedTiles[getTileIndex(pos)] = guard.valid();
+}
+
+void CMap::updateGuardingCreaturePositions(const CGObjectInstance * obj)
+{
+	// Guard of a tile depends only on objects of the tile and its neighbours
+	int3 pos;
+	pos.z = obj->pos.z;
+	for(pos.x = obj->pos.x - obj->getWidth(); pos.x <= obj->pos.x + 1; ++pos.x)
+	{
+		for(pos.y = obj->pos.y - obj->getHeight(); pos.y <= obj->pos.y + 1; ++pos.y)
+		{
+			if(isInTheMap(pos))
+				setGuardingCreaturePosition(pos, guardingCreaturePosition(pos));
 		}
 	}
 }
@@ -625,18 +631,10 @@ void CMap::addNewObject(CGObjectInstance * obj)
 void CMap::initTerrain()
 {
 	int level = twoLevel ? 2 : 1;
-	terrain = new TerrainTile**[width];
-	guardingCreaturePositions = new int3**[width];
-	for (int i = 0; i < width; ++i)
-	{
-		terrain[i] = new TerrainTile*[height];
-		guardingCreaturePositions[i] = new int3*[height];
-		for (int j = 0; j < height; ++j)
-		{
-			terrain[i][j] = new TerrainTile[level];
-			guardingCreaturePositions[i][j] = new int3[level];
-		}
-	}
+	terrain.resize(boost::extents[width][height][level]);
+	guardingCreaturePositions.resize(boost::extents[width][height][level]);
+	std::fill_n(guardingCreaturePositions.data(), guardingCreaturePositions.num_elements(), int3(-1, -1, -1));
+	guardedTiles.assign(terrain.num_elements(), false);
 }
 
 CMapEditManager * CMap::getEditManager()
@@ -363,7 +363,13 @@ public:
 	bool canMoveBetween(const int3 &src, const int3 &dst) const;
 	bool checkForVisitableDir( const int3 & src, const TerrainTile *pom, const int3 & dst ) const;
 	int3 guardingCreaturePosition (int3 pos) const;
+	/// Tests whether a monster guards the tile, reads the packed layer kept along with guardingCreaturePositions
+	bool isTileGuarded(const int3 & pos) const
+	{
+		return guardedTiles[getTileIndex(pos)];
+	}
 
+	/// Guarding creature positions around the object are updated along with the tiles
 	void addBlockVisTiles(CGObjectInstance * obj);
 	void removeBlockVisTiles(CGObjectInstance * obj, bool total = false);
 	void calculateGuardingGreaturePositions();
@@ -412,13 +418,24 @@ public:
 
 	std::unique_ptr<CMapEditManager> editManager;
 
-	int3 ***guardingCreaturePositions;
+	/// positions of monsters guarding each tile, access is as follows: x, y, level
+	boost::multi_array<int3, 3> guardingCreaturePositions;
 
 	std::map<std::string, ConstTransitivePtr<CGObjectInstance> > instanceNames;
 
 private:
-	/// a 3-dimensional array of terrain tiles, access is as follows: x, y, level. where level=1 is underground
-	TerrainTile*** terrain;
+	/// a 3-dimensional array of terrain tiles in a single buffer, access is as follows: x, y, level. where level=1 is underground
+	boost::multi_array<TerrainTile, 3> terrain;
+	/// one bit per tile in the order of terrain, set if the tile has a valid guarding creature position
+	std::vector<bool> guardedTiles;
+
+	size_t getTileIndex(const int3 & pos) const
+	{
+		return (pos.x * height + pos.y) * (twoLevel ? 2 : 1) + pos.z;
+	}
+	void setGuardingCreaturePosition(const int3 & pos, const int3 & guard);
+	/// Recalculates guards of the object tiles and tiles around them
+	void updateGuardingCreaturePositions(const CGObjectInstance * obj);
 
 public:
 	template <typename Handler>
@@ -438,47 +455,27 @@ public:
 
 		//TODO: viccondetails
 		int level = twoLevel ? 2 : 1;
-		if(h.saving)
+		if(!h.saving)
 		{
-			// Save terrain
-			for(int i = 0; i < width ; ++i)
-			{
-				for(int j = 0; j < height ; ++j)
-				{
-					for(int k = 0; k < level; ++k)
-					{
-						h & terrain[i][j][k];
-						h & guardingCreaturePositions[i][j][k];
-					}
-				}
-			}
+			initTerrain();
 		}
-		else
+		for(int i = 0; i < width ; ++i)
 		{
-			// Load terrain
-			terrain = new TerrainTile**[width];
-			guardingCreaturePositions = new int3**[width];
-			for(int i = 0; i < width; ++i)
+			for(int j = 0; j < height ; ++j)
 			{
-				terrain[i] = new TerrainTile*[height];
-				guardingCreaturePositions[i] = new int3*[height];
-				for(int j = 0; j < height; ++j)
+				for(int k = 0; k < level; ++k)
 				{
-					terrain[i][j] = new TerrainTile[level];
-					guardingCreaturePositions[i][j] = new int3[level];
+					h & terrain[i][j][k];
+					h & guardingCreaturePositions[i][j][k];
 				}
 			}
+		}
+		if(!h.saving)
+		{
 			for(int i = 0; i < width ; ++i)
-			{
 				for(int j = 0; j < height ; ++j)
-				{
 					for(int k = 0; k < level; ++k)
-					{
-						h & terrain[i][j][k];
-						h & guardingCreaturePositions[i][j][k];
-					}
-				}
-			}
+						guardedTiles[getTileIndex(int3(i, j, k))] = guardingCreaturePositions[i][j][k].valid();
 		}
 
 		h & objects;
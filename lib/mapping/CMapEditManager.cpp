@@ -15,6 +15,7 @@
 #include "../mapObjects/CObjectClassesHandler.h"
 #include "../mapObjects/CGHeroInstance.h"
 #include "../VCMI_Lib.h"
+#include "../CThreadHelper.h"
 #include "CDrawRoadsOperation.h"
 #include "../mapping/CMap.h"
 
@@ -228,11 +229,16 @@ const CMapOperation * CMapUndoManager::peek(const TStack & stack) const
 }
 
 CMapEditManager::CMapEditManager(CMap * map)
-	: map(map), terrainSel(map), objectSel(map)
+	: map(map), terrainSel(map), objectSel(map), threadCount(0)
 {
 
 }
 
+void CMapEditManager::setThreadCount(int threads)
+{
+	threadCount = threads;
+}
+
 CMap * CMapEditManager::getMap()
 {
 	return map;
@@ -245,7 +251,7 @@ void CMapEditManager::clearTerrain(CRandomGenerator * gen)
 
 void CMapEditManager::drawTerrain(ETerrainType terType, CRandomGenerator * gen)
 {
-	execute(make_unique<CDrawTerrainOperation>(map, terrainSel, terType, gen ? gen : &(this->gen)));
+	execute(make_unique<CDrawTerrainOperation>(map, terrainSel, terType, gen ? gen : &(this->gen), threadCount));
 	terrainSel.clearSelection();
 }
 
@@ -351,7 +357,165 @@ void TerrainViewPattern::WeightedRule::setNative()
 	dirtRule = sandRule = transitionRule = nativeStrongRule = anyRule = false; //no idea what they mean, but look mutually exclusive
 }
 
+/// What rules of terrain view patterns test about a cell of the 3x3 neighbourhood of a tile.
+struct TerrainViewCell
+{
+	bool inMap;
+	bool alien; //inside of the map and has another terrain type than the center
+	bool sand;
+};
+
+/// Validates the pattern against the neighbourhood cells. Rules referencing other patterns are tested with checkReference
+/// at native cells inside of the map if checkReferences is set, otherwise they are treated as native rules.
+template<typename ReferenceCheck>
+static bool matchTerrainViewPattern(const TerrainViewPattern & pattern, ETerrainGroup::ETerrainGroup centerTerGroup, const TerrainViewCell * cells,
+	bool checkReferences, const ReferenceCheck & checkReference, std::string & transitionReplacement)
+{
+	int totalPoints = 0;
+	for(int i = 0; i < 9; ++i)
+	{
+		// The center, middle cell can be skipped
+		if(i == 4)
+		{
+			continue;
+		}
+
+		const TerrainViewCell & cell = cells[i];
+
+		// Validate all rules per cell
+		int topPoints = -1;
+		for(const auto & rule : pattern.data[i])
+		{
+			if(!rule.isStandardRule() && checkReferences && cell.inMap)
+			{
+				if(!cell.alien && checkReference(i, rule))
+				{
+					topPoints = std::max(topPoints, rule.points);
+				}
+				continue;
+			}
+
+			// Other flags of a referencing rule are not set, so only this one needs to be replaced
+			const bool isNativeRule = rule.isNativeRule() || !rule.isStandardRule();
+			bool rslt = false;
+
+			// Validate cell with the ruleset of the pattern
+			bool nativeTestOk, nativeTestStrongOk;
+			nativeTestOk = nativeTestStrongOk = (rule.isNativeStrong() || isNativeRule) && !cell.alien;
+			if(centerTerGroup == ETerrainGroup::NORMAL)
+			{
+				bool dirtTestOk = (rule.isDirtRule() || rule.isTransition())
+						&& cell.alien && !cell.sand;
+				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
+						&& cell.sand;
+
+				if (transitionReplacement.empty() && rule.isTransition()
+						&& (dirtTestOk || sandTestOk))
+				{
+					transitionReplacement = dirtTestOk ? TerrainViewPattern::RULE_DIRT : TerrainViewPattern::RULE_SAND;
+				}
+				if (rule.isTransition())
+				{
+					rslt = (dirtTestOk && transitionReplacement != TerrainViewPattern::RULE_SAND) ||
+							(sandTestOk && transitionReplacement != TerrainViewPattern::RULE_DIRT);
+				}
+				else
+				{
+					rslt = rule.isAnyRule() || dirtTestOk || sandTestOk || nativeTestOk;
+				}
+			}
+			else if(centerTerGroup == ETerrainGroup::DIRT)
+			{
+				nativeTestOk = isNativeRule && !cell.sand;
+				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
+						&& cell.sand;
+				rslt = rule.isAnyRule() || sandTestOk || nativeTestOk || nativeTestStrongOk;
+			}
+			else if(centerTerGroup == ETerrainGroup::SAND)
+			{
+				rslt = true;
+			}
+			else if(centerTerGroup == ETerrainGroup::WATER || centerTerGroup == ETerrainGroup::ROCK)
+			{
+				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
+						&& cell.alien;
+				rslt = rule.isAnyRule() || sandTestOk || nativeTestOk;
+			}
+
+			if(rslt)
+			{
+				topPoints = std::max(topPoints, rule.points);
+			}
+		}
+
+		if(topPoints == -1)
+		{
+			return false;
+		}
+		totalPoints += topPoints;
+	}
+
+	return totalPoints >= pattern.minPoints && totalPoints <= pattern.maxPoints;
+}
+
+static ETerrainViewCell::ETerrainViewCell getTerrainViewCellType(const TerrainViewCell & cell)
+{
+	if(!cell.inMap)
+		return cell.sand ? ETerrainViewCell::OUTSIDE_SAND : ETerrainViewCell::OUTSIDE;
+	if(!cell.alien)
+		return ETerrainViewCell::NATIVE;
+	return cell.sand ? ETerrainViewCell::ALIEN_SAND : ETerrainViewCell::ALIEN;
+}
+
+/// Restores the cells from the signature, the first neighbour is the lowest digit
+static void decodeTerrainViewSignature(ETerrainGroup::ETerrainGroup terGroup, int signature, TerrainViewCell * cells)
+{
+	// Sand types have their own groups
+	const bool centerSand = terGroup == ETerrainGroup::SAND || terGroup == ETerrainGroup::WATER || terGroup == ETerrainGroup::ROCK;
+	for(int i = 0; i < 9; ++i)
+	{
+		TerrainViewCell & cell = cells[i];
+		if(i == 4)
+		{
+			cell.inMap = true;
+			cell.alien = false;
+			cell.sand = centerSand;
+			continue;
+		}
+
+		const auto cellType = static_cast<ETerrainViewCell::ETerrainViewCell>(signature % ETerrainViewCell::TYPES_COUNT);
+		signature /= ETerrainViewCell::TYPES_COUNT;
+
+		cell.inMap = cellType != ETerrainViewCell::OUTSIDE && cellType != ETerrainViewCell::OUTSIDE_SAND;
+		cell.alien = cellType == ETerrainViewCell::ALIEN || cellType == ETerrainViewCell::ALIEN_SAND;
+		switch(cellType)
+		{
+		case ETerrainViewCell::NATIVE:
+			cell.sand = centerSand;
+			break;
+		case ETerrainViewCell::ALIEN_SAND:
+		case ETerrainViewCell::OUTSIDE_SAND:
+			cell.sand = true;
+			break;
+		default:
+			cell.sand = false;
+			break;
+		}
+	}
+}
+
+// Layout of the signature table entries
+static const ui32 VIEW_KNOWN = 1 << 0;
+static const ui32 VIEW_AMBIGUOUS = 1 << 1;
+static const int VIEW_FLIP_SHIFT = 2; //2 bits
+static const int VIEW_TRANSITION_SHIFT = 4; //2 bits, 0 - none, 1 - dirt, 2 - sand
+static const int VIEW_PATTERN_SHIFT = 8; //8 bits, index of the pattern + 1, 0 if no pattern fits
+static const ui32 TYPES_KNOWN = 1 << 16;
+static const ui32 TYPES_AMBIGUOUS = 1 << 17;
+static const int TYPES_SHIFT = 18; //bit for each terrain type pattern
+
 CTerrainViewPatternConfig::CTerrainViewPatternConfig()
+	: referencesMonotone(true)
 {
 	const JsonNode config(ResourceID("config/terrainViewPatterns.json"));
 	static const std::string patternTypes[] = { "terrainView", "terrainType" };
@@ -446,6 +610,17 @@ CTerrainViewPatternConfig::CTerrainViewPatternConfig()
 			}
 		}
 	}
+
+	for(const auto & groupPatterns : terrainViewPatterns)
+	{
+		assert(groupPatterns.second.size() < 0xFF);
+		for(const auto & patternFlips : groupPatterns.second)
+		{
+			if(patternFlips.front().maxPoints != std::numeric_limits<int>::max())
+				referencesMonotone = false;
+		}
+	}
+	assert(terrainTypePatterns.size() <= 32 - TYPES_SHIFT);
 }
 
 CTerrainViewPatternConfig::~CTerrainViewPatternConfig()
@@ -534,8 +709,141 @@ void CTerrainViewPatternConfig::flipPattern(TerrainViewPattern & pattern, int fl
 }
 
 
-CDrawTerrainOperation::CDrawTerrainOperation(CMap * map, const CTerrainSelection & terrainSel, ETerrainType terType, CRandomGenerator * gen)
-	: CMapOperation(map), terrainSel(terrainSel), terType(terType), gen(gen)
+CTerrainViewPatternConfig::TerrainViewMatch CTerrainViewPatternConfig::getTerrainViewMatch(ETerrainGroup::ETerrainGroup terGroup, int signature) const
+{
+	const ui32 entry = getSignatureEntry(terGroup, signature, VIEW_KNOWN);
+
+	TerrainViewMatch match;
+	match.ambiguous = (entry & VIEW_AMBIGUOUS) != 0;
+	match.pattern = static_cast<int>((entry >> VIEW_PATTERN_SHIFT) & 0xFF) - 1;
+	match.flip = (entry >> VIEW_FLIP_SHIFT) & 3;
+	switch((entry >> VIEW_TRANSITION_SHIFT) & 3)
+	{
+	case 1:
+		match.transitionReplacement = TerrainViewPattern::RULE_DIRT;
+		break;
+	case 2:
+		match.transitionReplacement = TerrainViewPattern::RULE_SAND;
+		break;
+	}
+	return match;
+}
+
+boost::logic::tribool CTerrainViewPatternConfig::matchTerrainTypePattern(ETerrainGroup::ETerrainGroup terGroup, int signature, const std::string & id) const
+{
+	auto it = terrainTypePatterns.find(id);
+	assert(it != terrainTypePatterns.end());
+	const int index = std::distance(terrainTypePatterns.begin(), it);
+
+	const ui32 entry = getSignatureEntry(terGroup, signature, TYPES_KNOWN);
+	if(entry & TYPES_AMBIGUOUS)
+		return boost::logic::indeterminate;
+	return ((entry >> (TYPES_SHIFT + index)) & 1) != 0;
+}
+
+ui32 CTerrainViewPatternConfig::getSignatureEntry(ETerrainGroup::ETerrainGroup terGroup, int signature, ui32 part) const
+{
+	assert(signature >= 0 && signature < SIGNATURE_COUNT);
+	std::call_once(signatureTablesAllocated[terGroup], [this, terGroup]()
+	{
+		signatureTables[terGroup].reset(new std::atomic<ui32>[SIGNATURE_COUNT]());
+	});
+	auto & entry = signatureTables[terGroup][signature];
+	ui32 value = entry.load(std::memory_order_relaxed);
+	if(!(value & part))
+	{
+		// Results don't depend on the thread, so it doesn't matter which one stores them first
+		TerrainViewCell cells[9];
+		decodeTerrainViewSignature(terGroup, signature, cells);
+		const ui32 computed = part | (part == VIEW_KNOWN ? matchViewPatterns(terGroup, cells) : matchTypePatterns(terGroup, cells));
+		value = entry.fetch_or(computed, std::memory_order_relaxed) | computed;
+	}
+	return value;
+}
+
+ui32 CTerrainViewPatternConfig::matchViewPatterns(ETerrainGroup::ETerrainGroup terGroup, const TerrainViewCell * cells) const
+{
+	const auto & patterns = getTerrainViewPatternsForGroup(terGroup);
+
+	// Referenced patterns are validated on neighbour tiles, out of the signature. Try all of them failing
+	// and all of them fitting, if results are the same any other combination can't change it.
+	bool referencesUsed = false;
+	auto findPattern = [&](bool referencesFit) -> ui32
+	{
+		auto checkReference = [&](int cellIndex, const TerrainViewPattern::WeightedRule & rule) -> bool
+		{
+			if(!getTerrainViewPatternsById(terGroup, rule.name))
+				return false;
+			referencesUsed = true;
+			return referencesFit;
+		};
+
+		for(int k = 0; k < patterns.size(); ++k)
+		{
+			for(int flip = 0; flip < 4; ++flip)
+			{
+				std::string transitionReplacement;
+				if(matchTerrainViewPattern(patterns[k][flip], terGroup, cells, true, checkReference, transitionReplacement))
+				{
+					ui32 transition = 0;
+					if(transitionReplacement == TerrainViewPattern::RULE_DIRT)
+						transition = 1;
+					else if(transitionReplacement == TerrainViewPattern::RULE_SAND)
+						transition = 2;
+					return ((k + 1) << VIEW_PATTERN_SHIFT) | (flip << VIEW_FLIP_SHIFT) | (transition << VIEW_TRANSITION_SHIFT);
+				}
+			}
+		}
+		return 0;
+	};
+
+	ui32 result = findPattern(false);
+	if(referencesUsed && (!referencesMonotone || findPattern(true) != result))
+	{
+		result |= VIEW_AMBIGUOUS;
+	}
+	return result;
+}
+
+ui32 CTerrainViewPatternConfig::matchTypePatterns(ETerrainGroup::ETerrainGroup terGroup, const TerrainViewCell * cells) const
+{
+	bool referencesUsed = false;
+	auto checkReference = [&](int cellIndex, const TerrainViewPattern::WeightedRule & rule) -> bool
+	{
+		if(!getTerrainViewPatternsById(terGroup, rule.name))
+			return false;
+		referencesUsed = true;
+		return false;
+	};
+
+	ui32 result = 0;
+	int index = 0;
+	for(const auto & patternFlips : terrainTypePatterns)
+	{
+		for(int flip = 0; flip < 4; ++flip)
+		{
+			std::string transitionReplacement;
+			if(matchTerrainViewPattern(patternFlips.second[flip], terGroup, cells, true, checkReference, transitionReplacement))
+			{
+				result |= 1 << (TYPES_SHIFT + index);
+				break;
+			}
+		}
+		index++;
+	}
+
+	if(referencesUsed)
+	{
+		result |= TYPES_AMBIGUOUS;
+	}
+	return result;
+}
+
+const size_t CDrawTerrainOperation::MIN_TILES_PER_VIEW_STRIP;
+const int CDrawTerrainOperation::VIEW_STRIPS_PER_THREAD;
+
+CDrawTerrainOperation::CDrawTerrainOperation(CMap * map, const CTerrainSelection & terrainSel, ETerrainType terType, CRandomGenerator * gen, int threadCount)
+	: CMapOperation(map), terrainSel(terrainSel), terType(terType), gen(gen), threadCount(threadCount)
 {
 
 }
@@ -703,24 +1011,48 @@ void CDrawTerrainOperation::updateTerrainTypes()
 
 void CDrawTerrainOperation::updateTerrainViews()
 {
-	for(const auto & pos : invalidatedTerViews)
+	// Views depend only on terrain types, which aren't changed by this pass, so strips of tiles can be matched
+	// independently. Frames are picked afterwards in the order of positions to keep the random stream intact.
+	std::vector<int3> positions(invalidatedTerViews.begin(), invalidatedTerViews.end());
+	std::vector<int> bestPatterns(positions.size(), -1);
+	std::vector<ValidationResult> valRslts(positions.size(), ValidationResult(false));
+
+	auto matchStrip = [&](size_t begin, size_t end)
 	{
-		const auto & patterns = VLC->terviewh->getTerrainViewPatternsForGroup(getTerrainGroup(map->getTile(pos).terType));
+		for(size_t i = begin; i < end; ++i)
+		{
+			valRslts[i] = findTerrainViewPattern(positions[i], bestPatterns[i]);
+		}
+	};
 
-		// Detect a pattern which fits best
-		int bestPattern = -1;
-		ValidationResult valRslt(false);
-		for(int k = 0; k < patterns.size(); ++k)
+	const int threads = threadCount > 0 ? threadCount : std::max<int>(1, boost::thread::hardware_concurrency());
+	const size_t stripSize = std::max(MIN_TILES_PER_VIEW_STRIP, positions.size() / (threads * VIEW_STRIPS_PER_THREAD) + 1);
+
+	if(threads == 1 || positions.size() <= stripSize)
+	{
+		matchStrip(0, positions.size());
+	}
+	else
+	{
+		std::vector<Task> tasks;
+		for(size_t begin = 0; begin < positions.size(); begin += stripSize)
 		{
-			const auto & pattern = patterns[k];
-			//(ETerrainGroup::ETerrainGroup terGroup, const std::string & id)
-			valRslt = validateTerrainView(pos, &pattern);
-			if(valRslt.result)
+			const size_t end = std::min(positions.size(), begin + stripSize);
+			tasks.push_back([&matchStrip, begin, end]()
 			{
-				bestPattern = k;
-				break;
-			}
+				matchStrip(begin, end);
+			});
 		}
+
+		CThreadHelper::runTasks(tasks, threads);
+	}
+
+	for(size_t i = 0; i < positions.size(); ++i)
+	{
+		const auto & pos = positions[i];
+		const int bestPattern = bestPatterns[i];
+		const auto & valRslt = valRslts[i];
+
 		//assert(bestPattern != -1);
 		if(bestPattern == -1)
 		{
@@ -731,6 +1063,7 @@ void CDrawTerrainOperation::updateTerrainViews()
 		}
 
 		// Get mapping
+		const auto & patterns = VLC->terviewh->getTerrainViewPatternsForGroup(getTerrainGroup(map->getTile(pos).terType));
 		const TerrainViewPattern & pattern = patterns[bestPattern][valRslt.flip];
 		std::pair<int, int> mapping;
 		if(valRslt.transitionReplacement.empty())
@@ -793,26 +1126,77 @@ CDrawTerrainOperation::ValidationResult CDrawTerrainOperation::validateTerrainVi
 
 CDrawTerrainOperation::ValidationResult CDrawTerrainOperation::validateTerrainViewInner(const int3 & pos, const TerrainViewPattern & pattern, int recDepth) const
 {
-	auto centerTerType = map->getTile(pos).terType;
-	auto centerTerGroup = getTerrainGroup(centerTerType);
-	int totalPoints = 0;
+	auto centerTerGroup = getTerrainGroup(map->getTile(pos).terType);
+	TerrainViewCell cells[9];
+	getTerrainViewCells(pos, cells);
+
+	auto checkReference = [&](int cellIndex, const TerrainViewPattern::WeightedRule & rule) -> bool
+	{
+		int3 currentPos(pos.x + (cellIndex % 3) - 1, pos.y + (cellIndex / 3) - 1, pos.z);
+		const auto & patternForRule = VLC->terviewh->getTerrainViewPatternsById(centerTerGroup, rule.name);
+		return patternForRule && validateTerrainView(currentPos, &(*patternForRule), 1).result;
+	};
+
 	std::string transitionReplacement;
+	if(matchTerrainViewPattern(pattern, centerTerGroup, cells, recDepth == 0, checkReference, transitionReplacement))
+	{
+		return ValidationResult(true, transitionReplacement);
+	}
+	else
+	{
+		return ValidationResult(false);
+	}
+}
 
-	for(int i = 0; i < 9; ++i)
+CDrawTerrainOperation::ValidationResult CDrawTerrainOperation::findTerrainViewPattern(const int3 & pos, int & bestPattern) const
+{
+	const auto terGroup = getTerrainGroup(map->getTile(pos).terType);
+	const auto match = VLC->terviewh->getTerrainViewMatch(terGroup, getTerrainViewSignature(pos));
+	if(!match.ambiguous)
 	{
-		// The center, middle cell can be skipped
-		if(i == 4)
+		bestPattern = match.pattern;
+		ValidationResult valRslt(bestPattern != -1, match.transitionReplacement);
+		valRslt.flip = match.flip;
+		return valRslt;
+	}
+
+	const auto & patterns = VLC->terviewh->getTerrainViewPatternsForGroup(terGroup);
+	for(int k = 0; k < patterns.size(); ++k)
+	{
+		auto valRslt = validateTerrainView(pos, &patterns[k]);
+		if(valRslt.result)
 		{
-			continue;
+			bestPattern = k;
+			return valRslt;
 		}
+	}
+	bestPattern = -1;
+	return ValidationResult(false);
+}
 
-		// Get terrain group of the current cell
+bool CDrawTerrainOperation::matchesTerrainTypePattern(const int3 & pos, int signature, const std::string & id) const
+{
+	auto rslt = VLC->terviewh->matchTerrainTypePattern(getTerrainGroup(map->getTile(pos).terType), signature, id);
+	if(boost::logic::indeterminate(rslt))
+	{
+		return validateTerrainView(pos, VLC->terviewh->getTerrainTypePatternById(id)).result;
+	}
+	return static_cast<bool>(rslt);
+}
+
+void CDrawTerrainOperation::getTerrainViewCells(const int3 & pos, TerrainViewCell * cells) const
+{
+	auto centerTerType = map->getTile(pos).terType;
+	for(int i = 0; i < 9; ++i)
+	{
 		int cx = pos.x + (i % 3) - 1;
 		int cy = pos.y + (i / 3) - 1;
 		int3 currentPos(cx, cy, pos.z);
-		bool isAlien = false;
+		TerrainViewCell & cell = cells[i];
+		cell.inMap = map->isInTheMap(currentPos);
+		cell.alien = false;
 		ETerrainType terType;
-		if(!map->isInTheMap(currentPos))
+		if(!cell.inMap)
 		{
 			// position is not in the map, so take the ter type from the neighbor tile
 			bool widthTooHigh = currentPos.x >= map->width;
@@ -844,109 +1228,27 @@ CDrawTerrainOperation::ValidationResult CDrawTerrainOperation::validateTerrainVi
 		else
 		{
 			terType = map->getTile(currentPos).terType;
-			if(terType != centerTerType)
-			{
-				isAlien = true;
-			}
+			cell.alien = terType != centerTerType;
 		}
+		cell.sand = isSandType(terType);
+	}
+}
 
-		// Validate all rules per cell
-		int topPoints = -1;
-		for(auto & elem : pattern.data[i])
-		{
-			TerrainViewPattern::WeightedRule rule = elem;
-			if(!rule.isStandardRule())
-			{
-				if(recDepth == 0 && map->isInTheMap(currentPos))
-				{
-					if(terType == centerTerType)
-					{
-						const auto & group = getTerrainGroup(centerTerType);
-						const auto & patternForRule = VLC->terviewh->getTerrainViewPatternsById(group, rule.name);
-						if(auto p = patternForRule)
-						{
-							auto rslt = validateTerrainView(currentPos, &(*p), 1);
-							if(rslt.result) topPoints = std::max(topPoints, rule.points);
-						}
-					}
-					continue;
-				}
-				else
-				{
-					rule.setNative();
-				}
-			}
-
-			auto applyValidationRslt = [&](bool rslt)
-			{
-				if(rslt)
-				{
-					topPoints = std::max(topPoints, rule.points);
-				}
-			};
-
-			// Validate cell with the ruleset of the pattern
-			bool nativeTestOk, nativeTestStrongOk;
-			nativeTestOk = nativeTestStrongOk = (rule.isNativeStrong() || rule.isNativeRule()) && !isAlien;
-			if(centerTerGroup == ETerrainGroup::NORMAL)
-			{
-				bool dirtTestOk = (rule.isDirtRule() || rule.isTransition())
-						&& isAlien && !isSandType(terType);
-				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
-						&& isSandType(terType);
-
-				if (transitionReplacement.empty() && rule.isTransition()
-						&& (dirtTestOk || sandTestOk))
-				{
-					transitionReplacement = dirtTestOk ? TerrainViewPattern::RULE_DIRT : TerrainViewPattern::RULE_SAND;
-				}
-				if (rule.isTransition())
-				{
-					applyValidationRslt((dirtTestOk && transitionReplacement != TerrainViewPattern::RULE_SAND) ||
-							(sandTestOk && transitionReplacement != TerrainViewPattern::RULE_DIRT));
-				}
-				else
-				{
-					applyValidationRslt(rule.isAnyRule() || dirtTestOk || sandTestOk || nativeTestOk);
-				}
-			}
-			else if(centerTerGroup == ETerrainGroup::DIRT)
-			{
-				nativeTestOk = rule.isNativeRule() && !isSandType(terType);
-				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
-						&& isSandType(terType);
-				applyValidationRslt(rule.isAnyRule() || sandTestOk || nativeTestOk || nativeTestStrongOk);
-			}
-			else if(centerTerGroup == ETerrainGroup::SAND)
-			{
-				applyValidationRslt(true);
-			}
-			else if(centerTerGroup == ETerrainGroup::WATER || centerTerGroup == ETerrainGroup::ROCK)
-			{
-				bool sandTestOk = (rule.isSandRule() || rule.isTransition())
-						&& isAlien;
-				applyValidationRslt(rule.isAnyRule() || sandTestOk || nativeTestOk);
-			}
-		}
+int CDrawTerrainOperation::getTerrainViewSignature(const int3 & pos) const
+{
+	TerrainViewCell cells[9];
+	getTerrainViewCells(pos, cells);
 
-		if(topPoints == -1)
-		{
-			return ValidationResult(false);
-		}
-		else
+	// The first neighbour is the lowest digit
+	int signature = 0;
+	for(int i = 8; i >= 0; --i)
+	{
+		if(i != 4)
 		{
-			totalPoints += topPoints;
+			signature = signature * ETerrainViewCell::TYPES_COUNT + getTerrainViewCellType(cells[i]);
 		}
 	}
-
-	if(totalPoints >= pattern.minPoints && totalPoints <= pattern.maxPoints)
-	{
-		return ValidationResult(true, transitionReplacement);
-	}
-	else
-	{
-		return ValidationResult(false);
-	}
+	return signature;
 }
 
 bool CDrawTerrainOperation::isSandType(ETerrainType terType) const
@@ -973,7 +1275,6 @@ void CDrawTerrainOperation::invalidateTerrainViews(const int3 & centerPos)
 
 CDrawTerrainOperation::InvalidTiles CDrawTerrainOperation::getInvalidTiles(const int3 & centerPos) const
 {
-	//TODO: this is very expensive function for RMG, needs optimization
 	InvalidTiles tiles;
 	auto centerTerType = map->getTile(centerPos).terType;
 	auto rect = extendTileAround(centerPos);
@@ -981,9 +1282,9 @@ CDrawTerrainOperation::InvalidTiles CDrawTerrainOperation::getInvalidTiles(const
 	{
 		if(map->isInTheMap(pos))
 		{
-			auto ptrConfig = VLC->terviewh;
 			auto terType = map->getTile(pos).terType;
-			auto valid = validateTerrainView(pos, ptrConfig->getTerrainTypePatternById("n1")).result;
+			auto signature = getTerrainViewSignature(pos);
+			auto valid = matchesTerrainTypePattern(pos, signature, "n1");
 
 			// Special validity check for rock & water
 			if(valid && (terType == ETerrainType::WATER || terType == ETerrainType::ROCK))
@@ -991,7 +1292,7 @@ CDrawTerrainOperation::InvalidTiles CDrawTerrainOperation::getInvalidTiles(const
 				static const std::string patternIds[] = { "s1", "s2" };
 				for(auto & patternId : patternIds)
 				{
-					valid = !validateTerrainView(pos, ptrConfig->getTerrainTypePatternById(patternId)).result;
+					valid = !matchesTerrainTypePattern(pos, signature, patternId);
 					if(!valid) break;
 				}
 			}
@@ -1001,7 +1302,7 @@ CDrawTerrainOperation::InvalidTiles CDrawTerrainOperation::getInvalidTiles(const
 				static const std::string patternIds[] = { "n2", "n3" };
 				for(auto & patternId : patternIds)
 				{
-					valid = validateTerrainView(pos, ptrConfig->getTerrainTypePatternById(patternId)).result;
+					valid = matchesTerrainTypePattern(pos, signature, patternId);
 					if(valid) break;
 				}
 			}
@@ -1055,6 +1356,58 @@ void CTerrainViewPatternUtils::printDebuggingInfoAboutTile(const CMap * map, int
 	}
 }
 
+std::vector<int3> CTerrainViewPatternUtils::findTerrainViewTableMismatches(CMap * map)
+{
+	static const std::string typePatternIds[] = { "n1", "n2", "n3", "s1", "s2" };
+
+	std::vector<int3> mismatches;
+	CDrawTerrainOperation operation(map, CTerrainSelection(map), ETerrainType::WRONG, nullptr);
+	const auto ptrConfig = VLC->terviewh;
+	for(int z = 0; z < (map->twoLevel ? 2 : 1); ++z)
+	{
+		for(int y = 0; y < map->height; ++y)
+		{
+			for(int x = 0; x < map->width; ++x)
+			{
+				int3 pos(x, y, z);
+				auto terGroup = operation.getTerrainGroup(map->getTile(pos).terType);
+				auto signature = operation.getTerrainViewSignature(pos);
+				bool same = true;
+
+				auto match = ptrConfig->getTerrainViewMatch(terGroup, signature);
+				if(!match.ambiguous)
+				{
+					const auto & patterns = ptrConfig->getTerrainViewPatternsForGroup(terGroup);
+					int bestPattern = -1;
+					CDrawTerrainOperation::ValidationResult valRslt(false);
+					for(int k = 0; k < patterns.size() && bestPattern == -1; ++k)
+					{
+						valRslt = operation.validateTerrainView(pos, &patterns[k]);
+						if(valRslt.result)
+							bestPattern = k;
+					}
+					same = match.pattern == bestPattern && (bestPattern == -1
+						|| (match.flip == valRslt.flip && match.transitionReplacement == valRslt.transitionReplacement));
+				}
+
+				for(auto & id : typePatternIds)
+				{
+					auto rslt = ptrConfig->matchTerrainTypePattern(terGroup, signature, id);
+					if(!boost::logic::indeterminate(rslt)
+						&& static_cast<bool>(rslt) != operation.validateTerrainView(pos, ptrConfig->getTerrainTypePatternById(id)).result)
+					{
+						same = false;
+					}
+				}
+
+				if(!same)
+					mismatches.push_back(pos);
+			}
+		}
+	}
+	return mismatches;
+}
+
 CClearTerrainOperation::CClearTerrainOperation(CMap * map, CRandomGenerator * gen) : CComposedOperation(map)
 {
 	CTerrainSelection terrainSel(map);
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "../CRandomGenerator.h"
 #include "../int3.h"
 #include "../GameConstants.h"
@@ -178,6 +180,9 @@ public:
 	CTerrainSelection & getTerrainSelection();
 	CObjectSelection & getObjectSelection();
 
+	/// Number of threads used to update terrain views of large selections, 0 - one per core. Result does not depend on it
+	void setThreadCount(int threads);
+
 	CMapUndoManager & getUndoManager();
 
 private:
@@ -188,6 +193,7 @@ private:
 	CRandomGenerator gen;
 	CTerrainSelection terrainSel;
 	CObjectSelection objectSel;
+	int threadCount;
 };
 
 /* ---------------------------------------------------------------------------- */
@@ -222,6 +228,23 @@ namespace ETerrainGroup
 	};
 }
 
+/// A neighbour of the tile as seen by standard rules of terrain view patterns. The neighbourhood signature
+/// of the tile is a number with a digit in base TYPES_COUNT for each of its 8 neighbours.
+namespace ETerrainViewCell
+{
+	enum ETerrainViewCell
+	{
+		NATIVE,
+		ALIEN,
+		ALIEN_SAND,
+		OUTSIDE, //outside of the map, takes terrain type of the closest tile inside
+		OUTSIDE_SAND,
+		TYPES_COUNT
+	};
+}
+
+struct TerrainViewCell;
+
 /// The terrain view pattern describes a specific composition of terrain tiles
 /// in a 3x3 matrix and notes which terrain view frame numbers can be used.
 struct DLL_LINKAGE TerrainViewPattern
@@ -334,6 +357,21 @@ class DLL_LINKAGE CTerrainViewPatternConfig : public boost::noncopyable
 public:
 	typedef std::vector<TerrainViewPattern> TVPVector;
 
+	/// Count of all neighbourhood signatures, TYPES_COUNT ^ 8
+	static const int SIGNATURE_COUNT = 390625;
+
+	/// The view pattern of the group which fits tiles with the given neighbourhood signature.
+	struct TerrainViewMatch
+	{
+		/// The result depends on rules referencing other patterns, so the tile has to be validated directly.
+		bool ambiguous;
+		/// Index in getTerrainViewPatternsForGroup, -1 if no pattern fits.
+		int pattern;
+		int flip;
+		/// The replacement of a T rule, either D or S.
+		std::string transitionReplacement;
+	};
+
 	CTerrainViewPatternConfig();
 	~CTerrainViewPatternConfig();
 
@@ -344,16 +382,30 @@ public:
 	ETerrainGroup::ETerrainGroup getTerrainGroup(const std::string & terGroup) const;
 	void flipPattern(TerrainViewPattern & pattern, int flip) const;
 
+	/// Patterns are matched to a signature once, the results are kept in a table shared by all threads.
+	TerrainViewMatch getTerrainViewMatch(ETerrainGroup::ETerrainGroup terGroup, int signature) const;
+	/// Returns indeterminate if the terrain type pattern has to be validated directly.
+	boost::logic::tribool matchTerrainTypePattern(ETerrainGroup::ETerrainGroup terGroup, int signature, const std::string & id) const;
+
 private:
 	std::map<ETerrainGroup::ETerrainGroup, std::vector<TVPVector> > terrainViewPatterns;
 	std::map<std::string, TVPVector> terrainTypePatterns;
+	/// Points of all view patterns are unbounded, so fitting referenced patterns can't make a pattern fail.
+	bool referencesMonotone;
+	/// Packed results for each signature of a group, zero until computed. Allocated on the first lookup in the group.
+	mutable std::array<std::unique_ptr<std::atomic<ui32>[]>, ETerrainGroup::ROCK + 1> signatureTables;
+	mutable std::array<std::once_flag, ETerrainGroup::ROCK + 1> signatureTablesAllocated;
+
+	ui32 getSignatureEntry(ETerrainGroup::ETerrainGroup terGroup, int signature, ui32 part) const;
+	ui32 matchViewPatterns(ETerrainGroup::ETerrainGroup terGroup, const TerrainViewCell * cells) const;
+	ui32 matchTypePatterns(ETerrainGroup::ETerrainGroup terGroup, const TerrainViewCell * cells) const;
 };
 
 /// The CDrawTerrainOperation class draws a terrain area on the map.
 class CDrawTerrainOperation : public CMapOperation
 {
 public:
-	CDrawTerrainOperation(CMap * map, const CTerrainSelection & terrainSel, ETerrainType terType, CRandomGenerator * gen);
+	CDrawTerrainOperation(CMap * map, const CTerrainSelection & terrainSel, ETerrainType terType, CRandomGenerator * gen, int threadCount = 0);
 
 	void execute() override;
 	void undo() override;
@@ -383,25 +435,42 @@ private:
 	void invalidateTerrainViews(const int3 & centerPos);
 	InvalidTiles getInvalidTiles(const int3 & centerPos) const;
 
+	/// Matches view patterns of invalidated tiles in strips on a worker pool, then sets views in order of positions.
 	void updateTerrainViews();
 	ETerrainGroup::ETerrainGroup getTerrainGroup(ETerrainType terType) const;
 	/// Validates the terrain view of the given position and with the given pattern. The first method wraps the
 	/// second method to validate the terrain view with the given pattern in all four flip directions(horizontal, vertical).
 	ValidationResult validateTerrainView(const int3 & pos, const std::vector<TerrainViewPattern> * pattern, int recDepth = 0) const;
 	ValidationResult validateTerrainViewInner(const int3 & pos, const TerrainViewPattern & pattern, int recDepth = 0) const;
+	/// Looks up the best view pattern in the precomputed table, validates the tile directly only if the table can't tell.
+	ValidationResult findTerrainViewPattern(const int3 & pos, int & bestPattern) const;
+	bool matchesTerrainTypePattern(const int3 & pos, int signature, const std::string & id) const;
+	void getTerrainViewCells(const int3 & pos, TerrainViewCell * cells) const;
+	int getTerrainViewSignature(const int3 & pos) const;
 	/// Tests whether the given terrain type is a sand type. Sand types are: Water, Sand and Rock
 	bool isSandType(ETerrainType terType) const;
 
+	/// Minimal count of consecutive invalidated tiles matched by one task, smaller updates are done on the calling thread.
+	static const size_t MIN_TILES_PER_VIEW_STRIP = 512;
+	/// Tiles are split into more strips than threads, as strips with many ambiguous tiles take longer.
+	static const int VIEW_STRIPS_PER_THREAD = 4;
+
 	CTerrainSelection terrainSel;
 	ETerrainType terType;
 	CRandomGenerator * gen;
+	int threadCount;
 	std::set<int3> invalidatedTerViews;
+
+	friend class CTerrainViewPatternUtils;
 };
 
 class DLL_LINKAGE CTerrainViewPatternUtils
 {
 public:
 	static void printDebuggingInfoAboutTile(const CMap * map, int3 pos);
+	/// Compares patterns taken from the lookup table with patterns validated directly for every tile of the map,
+	/// returns tiles where they differ.
+	static std::vector<int3> findTerrainViewTableMismatches(CMap * map);
 };
 
 /// The CClearTerrainOperation clears+initializes the terrain.
@@ -217,8 +217,7 @@ const CRmgTemplate * CMapGenOptions::getMapTemplate() const
 void CMapGenOptions::setMapTemplate(const CRmgTemplate * value)
 {
 	mapTemplate = value;
-	//TODO validate & adapt options according to template
-	assert(0);
+	//TODO adapt options according to template, for now they are only validated in checkOptions
 }
 
 const std::map<std::string, CRmgTemplate *> & CMapGenOptions::getAvailableTemplates() const
@@ -399,7 +398,7 @@ bool CMapGenOptions::checkOptions() const
 	assert(countHumanPlayers() > 0);
 	if(mapTemplate)
 	{
-		return true;
+		return isTemplateCompatible(mapTemplate);
 	}
 	else
 	{
@@ -415,43 +414,8 @@ const CRmgTemplate * CMapGenOptions::getPossibleTemplate(CRandomGenerator & rand
 	std::list<const CRmgTemplate *> potentialTpls;
 	for(const auto & tplPair : tpls)
 	{
-		const auto & tpl = tplPair.second;
-		int3 tplSize(width, height, (hasTwoLevels ? 2 : 1));
-		if(tpl->matchesSize(tplSize))
-		{
-			bool isPlayerCountValid = false;
-			if (getPlayerCount() != RANDOM_SIZE)
-			{
-				if (tpl->getPlayers().isInRange(getPlayerCount()))
-					isPlayerCountValid = true;
-			}
-			else
-			{
-				// Human players shouldn't be banned when playing with random player count
-				auto playerNumbers = tpl->getPlayers().getNumbers();
-				if(countHumanPlayers() <= *boost::min_element(playerNumbers))
-				{
-					isPlayerCountValid = true;
-				}
-			}
-
-			if (isPlayerCountValid)
-			{
-				bool isCpuPlayerCountValid = false;
-				if(compOnlyPlayerCount != RANDOM_SIZE)
-				{
-					if (tpl->getCpuPlayers().isInRange(compOnlyPlayerCount))
-						isCpuPlayerCountValid = true;
-				}
-				else
-				{
-					isCpuPlayerCountValid = true;
-				}
-
-				if(isCpuPlayerCountValid)
-					potentialTpls.push_back(tpl);
-			}
-		}
+		if(isTemplateCompatible(tplPair.second))
+			potentialTpls.push_back(tplPair.second);
 	}
 
 	// Select tpl
@@ -465,6 +429,37 @@ const CRmgTemplate * CMapGenOptions::getPossibleTemplate(CRandomGenerator & rand
 	}
 }
 
+bool CMapGenOptions::isTemplateCompatible(const CRmgTemplate * tpl) const
+{
+	int3 tplSize(width, height, (hasTwoLevels ? 2 : 1));
+	if(!tpl->matchesSize(tplSize))
+		return false;
+
+	bool isPlayerCountValid = false;
+	if (getPlayerCount() != RANDOM_SIZE)
+	{
+		if (tpl->getPlayers().isInRange(getPlayerCount()))
+			isPlayerCountValid = true;
+	}
+	else
+	{
+		// Human players shouldn't be banned when playing with random player count
+		auto playerNumbers = tpl->getPlayers().getNumbers();
+		if(countHumanPlayers() <= *boost::min_element(playerNumbers))
+		{
+			isPlayerCountValid = true;
+		}
+	}
+
+	if(!isPlayerCountValid)
+		return false;
+
+	if(compOnlyPlayerCount != RANDOM_SIZE)
+		return tpl->getCpuPlayers().isInRange(compOnlyPlayerCount);
+
+	return true;
+}
+
 CMapGenOptions::CPlayerSettings::CPlayerSettings() : color(0), startingTown(RANDOM_TOWN), playerType(EPlayerType::AI)
 {
 
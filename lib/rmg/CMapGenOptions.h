@@ -150,7 +150,8 @@ public:
 	/// this function fails.
 	void finalize(CRandomGenerator & rand);
 
-	/// Returns false if there is no template available which fits to the currently selected options.
+	/// Returns false if there is no template available which fits to the currently selected options,
+	/// or if the selected template does not fit them.
 	bool checkOptions() const;
 
 	static const si8 RANDOM_SIZE = -1;
@@ -163,6 +164,7 @@ private:
 	void updateCompOnlyPlayers();
 	void updatePlayers();
 	const CRmgTemplate * getPossibleTemplate(CRandomGenerator & rand) const;
+	bool isTemplateCompatible(const CRmgTemplate * tpl) const;
 
 	si32 width, height;
 	bool hasTwoLevels;
@@ -20,6 +20,7 @@
 #include "CZonePlacer.h"
 #include "CRmgTemplateZone.h"
 #include "../mapObjects/CObjectClassesHandler.h"
+#include "../CThreadHelper.h"
 
 static const int3 dirs4[] = {int3(0,1,0),int3(0,-1,0),int3(-1,0,0),int3(+1,0,0)};
 static const int3 dirsDiagonal[] = { int3(1,1,0),int3(1,-1,0),int3(-1,1,0),int3(-1,-1,0) };
@@ -60,10 +61,29 @@ void CMapGenerator::foreachDiagonaltNeighbour(const int3& pos, std::function<voi
 CMapGenerator::CMapGenerator() :
 	mapGenOptions(nullptr), randomSeed(0), editManager(nullptr),
 	zonesTotal(0), tiles(nullptr), prisonsRemaining(0),
-    monolithIndex(0)
+    monolithIndex(0), threadCount(0)
 {
 }
 
+void CMapGenerator::setThreadCount(int threads)
+{
+	threadCount = threads;
+}
+
+const std::vector<std::pair<std::string, si64>> & CMapGenerator::getPhaseTimes() const
+{
+	return phaseTimes;
+}
+
+void CMapGenerator::finishPhase(const std::string & name)
+{
+	auto now = std::chrono::steady_clock::now();
+	si64 duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - phaseStart).count();
+	phaseTimes.push_back(std::make_pair(name, duration));
+	phaseStart = now;
+	logGlobal->debug("Map generation phase '%s' took %d ms", name, duration);
+}
+
 void CMapGenerator::initTiles()
 {
 	map->initTerrain();
@@ -133,8 +153,12 @@ std::unique_ptr<CMap> CMapGenerator::generate(CMapGenOptions * mapGenOptions, in
 	rand.setSeed(this->randomSeed);
 	mapGenOptions->finalize(rand);
 
+	phaseTimes.clear();
+	phaseStart = std::chrono::steady_clock::now();
+
 	map = make_unique<CMap>();
 	editManager = map->getEditManager();
+	editManager->setThreadCount(threadCount);
 
 	try
 	{
@@ -146,6 +170,7 @@ std::unique_ptr<CMap> CMapGenerator::generate(CMapGenOptions * mapGenOptions, in
 		initPrisonsRemaining();
 		initQuestArtsRemaining();
 		genZones();
+		finishPhase("zone placement");
 		map->calculateGuardingGreaturePositions(); //clear map so that all tiles are unguarded
 		fillZones();
 		//updated guarded tiles will be calculated in CGameState::initMapObjects()
@@ -289,6 +314,10 @@ void CMapGenerator::genZones()
 	placer.placeZones(mapGenOptions, &rand);
 	placer.assignZones(mapGenOptions);
 
+	//seed zones in order of their id, so their content does not depend on order of processing
+	for(auto & it : zones)
+		it.second->setRandomSeed(rand.nextInt());
+
 	logGlobal->info("Zones generated successfully");
 }
 
@@ -317,6 +346,14 @@ void CMapGenerator::fillZones()
 		it.second->createBorder(); //once direct connections are done
 
 	createConnections2(); //subterranean gates and monoliths
+	finishPhase("towns and connections");
+
+	for (auto it : zones)
+		it.second->initContent();
+	finishPhase("zone content");
+
+	createZonePaths();
+	finishPhase("zone paths");
 
 	std::vector<std::shared_ptr<CRmgTemplateZone>> treasureZones;
 	for (auto it : zones)
@@ -325,6 +362,7 @@ void CMapGenerator::fillZones()
 		if (it.second->getType() == ETemplateZoneType::TREASURE)
 			treasureZones.push_back(it.second);
 	}
+	finishPhase("objects and treasures");
 
 	//set apriopriate free/occupied tiles, including blocked underground rock
 	createObstaclesCommon1();
@@ -337,6 +375,7 @@ void CMapGenerator::fillZones()
 	{
 		it.second->createObstacles2();
 	}
+	finishPhase("obstacles");
 
 	#define PRINT_MAP_BEFORE_ROADS false
 	if (PRINT_MAP_BEFORE_ROADS) //enable to debug
@@ -377,6 +416,7 @@ void CMapGenerator::fillZones()
 	{
 		it.second->connectRoads(); //draw roads after everything else has been placed
 	}
+	finishPhase("roads");
 
 	//find place for Grail
 	if (treasureZones.empty())
@@ -391,6 +431,22 @@ void CMapGenerator::fillZones()
 	logGlobal->info("Zones filled successfully");
 }
 
+void CMapGenerator::createZonePaths()
+{
+	//zones only touch their own tiles and random generator here, so result is same regardless of scheduling
+	std::vector<Task> tasks;
+	for (auto it : zones)
+	{
+		auto zone = it.second;
+		tasks.push_back([zone]()
+		{
+			zone->createPaths();
+		});
+	}
+
+	CThreadHelper::runTasks(tasks, threadCount);
+}
+
 void CMapGenerator::createObstaclesCommon1()
 {
 	if (map->twoLevel) //underground
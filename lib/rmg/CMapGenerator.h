@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <chrono>
+
 #include "../GameConstants.h"
 #include "../CRandomGenerator.h"
 #include "CMapGenOptions.h"
@@ -57,6 +59,11 @@ public:
 
 	std::unique_ptr<CMap> generate(CMapGenOptions * mapGenOptions, int RandomSeed = std::time(nullptr));
 
+	/// Number of threads used for zone paths and terrain views, 0 - one per core. Generated map does not depend on it
+	void setThreadCount(int threads);
+	/// Wall time of generation phases in milliseconds, in order of execution
+	const std::vector<std::pair<std::string, si64>> & getPhaseTimes() const;
+
 	CMapGenOptions * mapGenOptions;
 	std::unique_ptr<CMap> map;
 	CRandomGenerator rand;
@@ -115,6 +122,11 @@ private:
 	std::vector<ArtifactID> questArtifacts;
 	void checkIsOnMap(const int3 &tile) const; //throws
 
+	int threadCount;
+	std::vector<std::pair<std::string, si64>> phaseTimes;
+	std::chrono::steady_clock::time_point phaseStart;
+	void finishPhase(const std::string & name);
+
 	/// Generation methods
 	std::string getMapDescription() const;
 
@@ -125,6 +137,7 @@ private:
 	void initTiles();
 	void genZones();
 	void fillZones();
+	void createZonePaths();
 	void createObstaclesCommon1();
 	void createObstaclesCommon2();
 
@@ -29,6 +29,8 @@ class CMapEditManager;
 
 using namespace rmg; //TODO: move all to namespace
 
+static boost::thread_specific_ptr<CTileSearchBuffer> searchBuffers;
+
 
 
 void CRmgTemplateZone::addRoadNode(const int3& node)
@@ -122,6 +124,30 @@ void CRmgTemplateZone::setOptions(const ZoneOptions * options)
 void CRmgTemplateZone::setGenPtr(CMapGenerator * Gen)
 {
 	gen = Gen;
+
+	int3 mapSize(gen->map->width, gen->map->height, gen->map->twoLevel ? 2 : 1);
+	tileinfo.resize(mapSize);
+	possibleTiles.resize(mapSize);
+	freePaths.resize(mapSize);
+	roads.resize(mapSize);
+	tilesToConnectLater.resize(mapSize);
+}
+
+CTileSearchBuffer & CRmgTemplateZone::getSearchBuffer() const
+{
+	if(!searchBuffers.get())
+		searchBuffers.reset(new CTileSearchBuffer());
+
+	CTileSearchBuffer & buffer = *searchBuffers;
+	if(buffer.getMapSize() != tileinfo.getMapSize())
+		buffer.resize(tileinfo.getMapSize());
+
+	return buffer;
+}
+
+void CRmgTemplateZone::setRandomSeed(int seed)
+{
+	rand.setSeed(seed);
 }
 
 void CRmgTemplateZone::setQuestArtZone(std::shared_ptr<CRmgTemplateZone> otherZone)
@@ -129,7 +155,7 @@ void CRmgTemplateZone::setQuestArtZone(std::shared_ptr<CRmgTemplateZone> otherZo
 	questArtZone = otherZone;
 }
 
-std::set<int3>* CRmgTemplateZone::getFreePaths()
+CTileSet* CRmgTemplateZone::getFreePaths()
 {
 	return &freePaths;
 }
@@ -174,11 +200,11 @@ void CRmgTemplateZone::addTile (const int3 &pos)
 	tileinfo.insert(pos);
 }
 
-std::set<int3> CRmgTemplateZone::getTileInfo () const
+const CTileSet & CRmgTemplateZone::getTileInfo () const
 {
 	return tileinfo;
 }
-std::set<int3> CRmgTemplateZone::getPossibleTiles() const
+const CTileSet & CRmgTemplateZone::getPossibleTiles() const
 {
 	return possibleTiles;
 }
@@ -195,7 +221,7 @@ void CRmgTemplateZone::discardDistantTiles (float distance)
 	//		//gen->setOccupied(tile, ETileType::BLOCKED); //fixme: crash at rendering?
 	//	}
 	//}
-	vstd::erase_if (tileinfo, [distance, this](const int3 &tile) -> bool
+	tileinfo.eraseIf([distance, this](const int3 &tile) -> bool
 	{
 		return tile.dist2d(this->pos) > distance;
 	});
@@ -208,10 +234,14 @@ void CRmgTemplateZone::clearTiles()
 
 void CRmgTemplateZone::initFreeTiles ()
 {
-	vstd::copy_if (tileinfo, vstd::set_inserter(possibleTiles), [this](const int3 &tile) -> bool
+	for (auto tile : tileinfo)
 	{
-		return gen->isPossible(tile);
-	});
+		if (gen->isPossible(tile))
+		{
+			possibleTiles.insert(tile);
+			objectDistances.push(std::make_pair(tile, gen->getNearestObjectDistance(tile)));
+		}
+	}
 	if (freePaths.empty())
 	{
 		gen->setOccupied(pos, ETileType::FREE);
@@ -250,24 +280,26 @@ void CRmgTemplateZone::fractalize()
 		if (gen->isFree(tile))
 			freePaths.insert(tile);
 	}
-	std::vector<int3> clearedTiles (freePaths.begin(), freePaths.end());
-	std::set<int3> possibleTiles;
+	CTileBuckets clearedTiles(tileinfo.getMapSize(), 10);
+	for (auto tile : freePaths)
+		clearedTiles.insert(tile);
+	CTileSet possibleTiles(tileinfo.getMapSize());
 	std::set<int3> tilesToIgnore; //will be erased in this iteration
 
 	//the more treasure density, the greater distance between paths. Scaling is experimental.
 	int totalDensity = 0;
 	for (auto ti : treasureInfo)
 		totalDensity += ti.density;
-	const float minDistance = 10 * 10; //squared
+	const ui32 minDistance = 10 * 10; //squared
 
 	for (auto tile : tileinfo)
 	{
 		if (gen->isFree(tile))
-			clearedTiles.push_back(tile);
+			clearedTiles.insert(tile);
 		else if (gen->isPossible(tile))
 			possibleTiles.insert(tile);
 	}
-	assert (clearedTiles.size()); //this should come from zone connections
+	assert (freePaths.size()); //this should come from zone connections
 
 	std::vector<int3> nodes; //connect them with a grid
 
@@ -279,38 +311,23 @@ void CRmgTemplateZone::fractalize()
 		{
 			//link tiles in random order
 			std::vector<int3> tilesToMakePath(possibleTiles.begin(), possibleTiles.end());
-			RandomGeneratorUtil::randomShuffle(tilesToMakePath, gen->rand);
+			RandomGeneratorUtil::randomShuffle(tilesToMakePath, rand);
 
 			int3 nodeFound(-1, -1, -1);
 
 			for (auto tileToMakePath : tilesToMakePath)
 			{
-				//find closest free tile
-				float currentDistance = 1e10;
-				int3 closestTile(-1, -1, -1);
-
-				for (auto clearTile : clearedTiles)
+				if (clearedTiles.hasTileWithin(tileToMakePath, minDistance))
 				{
-					float distance = tileToMakePath.dist2dSQ(clearTile);
-
-					if (distance < currentDistance)
-					{
-						currentDistance = distance;
-						closestTile = clearTile;
-					}
-					if (currentDistance <= minDistance)
-					{
-						//this tile is close enough. Forget about it and check next one
-						tilesToIgnore.insert(tileToMakePath);
-						break;
-					}
+					//this tile is close enough. Forget about it and check next one
+					tilesToIgnore.insert(tileToMakePath);
 				}
-				//if tiles is not close enough, make path to it
-				if (currentDistance > minDistance)
+				else
 				{
+					//if tiles is not close enough, make path to it
 					nodeFound = tileToMakePath;
 					nodes.push_back(nodeFound);
-					clearedTiles.push_back(nodeFound); //from now on nearby tiles will be considered handled
+					clearedTiles.insert(nodeFound); //from now on nearby tiles will be considered handled
 					break; //next iteration - use already cleared tiles
 				}
 			}
@@ -318,7 +335,7 @@ void CRmgTemplateZone::fractalize()
 			for (auto tileToClear : tilesToIgnore)
 			{
 				//these tiles are already connected, ignore them
-				vstd::erase_if_present(possibleTiles, tileToClear);
+				possibleTiles.erase(tileToClear);
 			}
 			if (!nodeFound.valid()) //nothing else can be done (?)
 				break;
@@ -426,7 +443,7 @@ void CRmgTemplateZone::connectLater()
 	}
 }
 
-bool CRmgTemplateZone::crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, std::set<int3>* clearedTiles)
+bool CRmgTemplateZone::crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, CTileSet* clearedTiles)
 {
 /*
 make shortest path with free tiles, reachning dst or closest already free tile. Avoid blocks.
@@ -459,9 +476,9 @@ do not leave zone border
 				}
 				if (pos.dist2dSQ (dst) < distance)
 				{
-					if (!gen->isBlocked(pos))
+					if (gen->getZoneID(pos) == id)
 					{
-						if (gen->getZoneID(pos) == id)
+						if (!gen->isBlocked(pos))
 						{
 							if (gen->isPossible(pos))
 							{
@@ -543,16 +560,15 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
 	auto pq = createPiorityQueue();    // The set of tentative nodes to be evaluated, initially containing the start node
-	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
-	std::map<int3, float> distances;
+	CTileSearchBuffer & searchBuffer = getSearchBuffer();
+	searchBuffer.reset(); // closed nodes, navigated nodes and distances
 
 	gen->setRoad (src, ERoadType::NO_ROAD); //just in case zone guard already has road under it. Road under nodes will be added at very end
 
-	cameFrom[src] = int3(-1, -1, -1); //first node points to finish condition
+	searchBuffer.setCameFrom(src, int3(-1, -1, -1)); //first node points to finish condition
 	pq.push(std::make_pair(src, 0.f));
-	distances[src] = 0.f;
+	searchBuffer.setDistance(src, 0.f);
 	// Cost from start along best known path.
 
 	while (!pq.empty())
@@ -560,7 +576,7 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 		auto node = pq.top();
 		pq.pop(); //remove top element
 		int3 currentNode = node.first;
-		closed.insert (currentNode);
+		searchBuffer.close(currentNode);
 		auto currentTile = &gen->map->getTile(currentNode);
 
 		if (currentNode == dst || gen->isRoad(currentNode))
@@ -568,14 +584,14 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 			// The goal node was reached. Trace the path using
 			// the saved parent information and return path
 			int3 backTracking = currentNode;
-			while (cameFrom[backTracking].valid())
+			while (searchBuffer.getCameFrom(backTracking).valid())
 			{
 				// add node to path
 				roads.insert (backTracking);
 				gen->setRoad (backTracking, ERoadType::COBBLESTONE_ROAD);
 				//logGlobal->trace("Setting road at tile %s", backTracking);
 				// do the same for the predecessor
-				backTracking = cameFrom[backTracking];
+				backTracking = searchBuffer.getCameFrom(backTracking);
 			}
 			return true;
 		}
@@ -584,15 +600,14 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 			bool directNeighbourFound = false;
 			float movementCost = 1;
 
-			auto foo = [this, &pq, &distances, &closed, &cameFrom, &currentNode, &currentTile, &node, &dst, &directNeighbourFound, &movementCost](int3& pos) -> void
+			auto foo = [this, &searchBuffer, &pq, &currentNode, &currentTile, &node, &dst, &directNeighbourFound, &movementCost](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos)) //we already visited that node
+				if (searchBuffer.isClosed(pos)) //we already visited that node
 					return;
 				float distance = node.second + movementCost;
 				float bestDistanceSoFar = std::numeric_limits<float>::max();
-				auto it = distances.find(pos);
-				if (it != distances.end())
-					bestDistanceSoFar = it->second;
+				if (searchBuffer.hasDistance(pos))
+					bestDistanceSoFar = searchBuffer.getDistance(pos);
 
 				if (distance < bestDistanceSoFar)
 				{
@@ -605,8 +620,8 @@ bool CRmgTemplateZone::createRoad(const int3& src, const int3& dst)
 					{
 						if (gen->getZoneID(pos) == id || pos == dst) //otherwise guard position may appear already connected to other zone.
 						{
-							cameFrom[pos] = currentNode;
-							distances[pos] = distance;
+							searchBuffer.setCameFrom(pos, currentNode);
+							searchBuffer.setDistance(pos, distance);
 							pq.push(std::make_pair(pos, distance));
 							directNeighbourFound = true;
 						}
@@ -633,15 +648,17 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
+	if (!gen->map->isInTheMap(src)) //treasure piles may try to connect from below the map border
+		throw rmgException(boost::to_string(boost::format("Tile %s is outside the map") % src.toString()));
+
 	auto open = createPiorityQueue();    // The set of tentative nodes to be evaluated, initially containing the start node
-	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
-	std::map<int3, float> distances;
+	CTileSearchBuffer & searchBuffer = getSearchBuffer();
+	searchBuffer.reset(); // closed nodes, navigated nodes and distances
 
 	//int3 currentNode = src;
 
-	cameFrom[src] = int3(-1, -1, -1); //first node points to finish condition
-	distances[src] = 0.f;
+	searchBuffer.setCameFrom(src, int3(-1, -1, -1)); //first node points to finish condition
+	searchBuffer.setDistance(src, 0.f);
 	open.push(std::make_pair(src, 0.f));
 	// Cost from start along best known path.
 	// Estimated total cost from start to goal through y.
@@ -652,41 +669,40 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 		open.pop();
 		int3 currentNode = node.first;
 
-		closed.insert(currentNode);
+		searchBuffer.close(currentNode);
 
 		if (gen->isFree(currentNode)) //we reached free paths, stop
 		{
 			// Trace the path using the saved parent information and return path
 			int3 backTracking = currentNode;
-			while (cameFrom[backTracking].valid())
+			while (searchBuffer.getCameFrom(backTracking).valid())
 			{
 				gen->setOccupied(backTracking, ETileType::FREE);
-				backTracking = cameFrom[backTracking];
+				backTracking = searchBuffer.getCameFrom(backTracking);
 			}
 			return true;
 		}
 		else
 		{
-			auto foo = [this, &open, &closed, &cameFrom, &currentNode, &distances](int3& pos) -> void
+			auto foo = [this, &searchBuffer, &open, &currentNode](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos))
+				if (searchBuffer.isClosed(pos))
 					return;
 
 				//no paths through blocked or occupied tiles, stay within zone
 				if (gen->isBlocked(pos) || gen->getZoneID(pos) != id)
 					return;
 
-				int distance = distances[currentNode] + 1;
+				int distance = searchBuffer.getDistance(currentNode) + 1;
 				int bestDistanceSoFar = std::numeric_limits<int>::max();
-				auto it = distances.find(pos);
-				if (it != distances.end())
-					bestDistanceSoFar = it->second;
+				if (searchBuffer.hasDistance(pos))
+					bestDistanceSoFar = searchBuffer.getDistance(pos);
 
 				if (distance < bestDistanceSoFar)
 				{
-					cameFrom[pos] = currentNode;
+					searchBuffer.setCameFrom(pos, currentNode);
 					open.push(std::make_pair(pos, distance));
-					distances[pos] = distance;
+					searchBuffer.setDistance(pos, distance);
 				}
 			};
 
@@ -697,10 +713,10 @@ bool CRmgTemplateZone::connectPath(const int3& src, bool onlyStraight)
 		}
 
 	}
-	for (auto tile : closed) //these tiles are sealed off and can't be connected anymore
+	for (auto tile : searchBuffer.getClosed()) //these tiles are sealed off and can't be connected anymore
 	{
 		gen->setOccupied (tile, ETileType::BLOCKED);
-		vstd::erase_if_present(possibleTiles, tile);
+		possibleTiles.erase(tile);
 	}
 	return false;
 }
@@ -710,13 +726,12 @@ bool CRmgTemplateZone::connectWithCenter(const int3& src, bool onlyStraight)
 {
 	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
 
-	std::set<int3> closed;    // The set of nodes already evaluated.
 	auto open = createPiorityQueue(); // The set of tentative nodes to be evaluated, initially containing the start node
-	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
-	std::map<int3, float> distances;
+	CTileSearchBuffer & searchBuffer = getSearchBuffer();
+	searchBuffer.reset(); // closed nodes, navigated nodes and distances
 
-	cameFrom[src] = int3(-1, -1, -1); //first node points to finish condition
-	distances[src] = 0;
+	searchBuffer.setCameFrom(src, int3(-1, -1, -1)); //first node points to finish condition
+	searchBuffer.setDistance(src, 0);
 	open.push(std::make_pair(src, 0.f));
 	// Cost from start along best known path.
 
@@ -726,24 +741,24 @@ bool CRmgTemplateZone::connectWithCenter(const int3& src, bool onlyStraight)
 		open.pop();
 		int3 currentNode = node.first;
 
-		closed.insert(currentNode);
+		searchBuffer.close(currentNode);
 
 		if (currentNode == pos) //we reached center of the zone, stop
 		{
 			// Trace the path using the saved parent information and return path
 			int3 backTracking = currentNode;
-			while (cameFrom[backTracking].valid())
+			while (searchBuffer.getCameFrom(backTracking).valid())
 			{
 				gen->setOccupied(backTracking, ETileType::FREE);
-				backTracking = cameFrom[backTracking];
+				backTracking = searchBuffer.getCameFrom(backTracking);
 			}
 			return true;
 		}
 		else
 		{
-			auto foo = [this, &open, &closed, &cameFrom, &currentNode, &distances](int3& pos) -> void
+			auto foo = [this, &searchBuffer, &open, &currentNode](int3& pos) -> void
 			{
-				if (vstd::contains(closed, pos))
+				if (searchBuffer.isClosed(pos))
 					return;
 
 				if (gen->getZoneID(pos) != id)
@@ -757,17 +772,16 @@ bool CRmgTemplateZone::connectWithCenter(const int3& src, bool onlyStraight)
 				else
 					return;
 
-				float distance = distances[currentNode] + movementCost; //we prefer to use already free paths
+				float distance = searchBuffer.getDistance(currentNode) + movementCost; //we prefer to use already free paths
 				int bestDistanceSoFar = std::numeric_limits<int>::max(); //FIXME: boost::limits
-				auto it = distances.find(pos);
-				if (it != distances.end())
-					bestDistanceSoFar = it->second;
+				if (searchBuffer.hasDistance(pos))
+					bestDistanceSoFar = searchBuffer.getDistance(pos);
 
 				if (distance < bestDistanceSoFar)
 				{
-					cameFrom[pos] = currentNode;
+					searchBuffer.setCameFrom(pos, currentNode);
 					open.push(std::make_pair(pos, distance));
-					distances[pos] = distance;
+					searchBuffer.setDistance(pos, distance);
 				}
 			};
 
@@ -833,10 +847,10 @@ bool CRmgTemplateZone::addMonster(int3 &pos, si32 strength, bool clearSurroundin
 	}
 	if (possibleCreatures.size())
 	{
-		creId = *RandomGeneratorUtil::nextItem(possibleCreatures, gen->rand);
+		creId = *RandomGeneratorUtil::nextItem(possibleCreatures, rand);
 		amount = strength / VLC->creh->creatures[creId]->AIValue;
 		if (amount >= 4)
-			amount *= gen->rand.nextDouble(0.75, 1.25);
+			amount *= rand.nextDouble(0.75, 1.25);
 	}
 	else //just pick any available creature
 	{
@@ -879,7 +893,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 	int maxValue = treasureInfo.max;
 	int minValue = treasureInfo.min;
 
-	ui32 desiredValue = (gen->rand.nextInt(minValue, maxValue));
+	ui32 desiredValue = (rand.nextInt(minValue, maxValue));
 
 	int currentValue = 0;
 	CGObjectInstance * object = nullptr;
@@ -949,7 +963,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 
 			//randomize next position from among possible ones
 			std::vector<int3> boundaryCopy (boundary.begin(), boundary.end());
-			//RandomGeneratorUtil::randomShuffle(boundaryCopy, gen->rand);
+			//RandomGeneratorUtil::randomShuffle(boundaryCopy, rand);
 			auto chooseTopTile = [](const int3 & lhs, const int3 & rhs) -> bool
 			{
 				return lhs.y < rhs.y;
@@ -1094,7 +1108,7 @@ bool CRmgTemplateZone::createTreasurePile(int3 &pos, float minDistance, const CT
 	else //we did not place eveyrthing successfully
 	{
 		gen->setOccupied(pos, ETileType::BLOCKED); //TODO: refactor stop condition
-		vstd::erase_if_present(possibleTiles, pos);
+		possibleTiles.erase(pos);
 		return false;
 	}
 }
@@ -1127,9 +1141,9 @@ void CRmgTemplateZone::initTownType ()
 				if(!this->townsAreSameType)
 				{
 					if (townTypes.size())
-						subType = *RandomGeneratorUtil::nextItem(townTypes, gen->rand);
+						subType = *RandomGeneratorUtil::nextItem(townTypes, rand);
 					else
-						subType = *RandomGeneratorUtil::nextItem(getDefaultTownTypes(), gen->rand); //it is possible to have zone with no towns allowed
+						subType = *RandomGeneratorUtil::nextItem(getDefaultTownTypes(), rand); //it is possible to have zone with no towns allowed
 				}
 			}
 
@@ -1238,16 +1252,16 @@ void CRmgTemplateZone::initTownType ()
 	if (!totalTowns) //if there's no town present, get random faction for dwellings and pandoras
 	{
 		//25% chance for neutral
-		if (gen->rand.nextInt(1, 100) <= 25)
+		if (rand.nextInt(1, 100) <= 25)
 		{
 			townType = ETownType::NEUTRAL;
 		}
 		else
 		{
 			if (townTypes.size())
-				townType = *RandomGeneratorUtil::nextItem(townTypes, gen->rand);
+				townType = *RandomGeneratorUtil::nextItem(townTypes, rand);
 			else if (monsterTypes.size())
-				townType = *RandomGeneratorUtil::nextItem(monsterTypes, gen->rand); //this happens in Clash of Dragons in treasure zones, where all towns are banned
+				townType = *RandomGeneratorUtil::nextItem(monsterTypes, rand); //this happens in Clash of Dragons in treasure zones, where all towns are banned
 			else //just in any case
 				randomizeTownType();
 		}
@@ -1257,9 +1271,9 @@ void CRmgTemplateZone::initTownType ()
 void CRmgTemplateZone::randomizeTownType ()
 {
 	if (townTypes.size())
-		townType = *RandomGeneratorUtil::nextItem(townTypes, gen->rand);
+		townType = *RandomGeneratorUtil::nextItem(townTypes, rand);
 	else
-		townType = *RandomGeneratorUtil::nextItem(getDefaultTownTypes(), gen->rand); //it is possible to have zone with no towns allowed, we still need some
+		townType = *RandomGeneratorUtil::nextItem(getDefaultTownTypes(), rand); //it is possible to have zone with no towns allowed, we still need some
 }
 
 void CRmgTemplateZone::initTerrainType ()
@@ -1268,7 +1282,7 @@ void CRmgTemplateZone::initTerrainType ()
 	if (matchTerrainToTown && townType != ETownType::NEUTRAL)
 		terrainType = VLC->townh->factions[townType]->nativeTerrain;
 	else
-		terrainType = *RandomGeneratorUtil::nextItem(terrainTypes, gen->rand);
+		terrainType = *RandomGeneratorUtil::nextItem(terrainTypes, rand);
 
 	//TODO: allow new types of terrain?
 	if (pos.z)
@@ -1289,7 +1303,7 @@ void CRmgTemplateZone::paintZoneTerrain (ETerrainType terrainType)
 {
 	std::vector<int3> tiles(tileinfo.begin(), tileinfo.end());
 	gen->editManager->getTerrainSelection().setSelection(tiles);
-	gen->editManager->drawTerrain(terrainType, &gen->rand);
+	gen->editManager->drawTerrain(terrainType, &rand);
 }
 
 bool CRmgTemplateZone::placeMines ()
@@ -1505,7 +1519,7 @@ void CRmgTemplateZone::createTreasures()
 		bool stop = false;
 		do {
 			//optimization - don't check tiles which are not allowed
-			vstd::erase_if(possibleTiles, [this](const int3 &tile) -> bool
+			possibleTiles.eraseIf([this](const int3 &tile) -> bool
 			{
 				return !gen->isPossible(tile);
 			});
@@ -1542,7 +1556,7 @@ void CRmgTemplateZone::createObstacles1()
 			}
 		}
 		gen->editManager->getTerrainSelection().setSelection(accessibleTiles);
-		gen->editManager->drawTerrain(terrainType, &gen->rand);
+		gen->editManager->drawTerrain(terrainType, &rand);
 	}
 }
 
@@ -1586,7 +1600,7 @@ void CRmgTemplateZone::createObstacles2()
 
 	auto tryToPlaceObstacleHere = [this, &possibleObstacles](int3& tile, int index)-> bool
 	{
-		auto temp = *RandomGeneratorUtil::nextItem(possibleObstacles[index].second, gen->rand);
+		auto temp = *RandomGeneratorUtil::nextItem(possibleObstacles[index].second, rand);
 		int3 obstaclePos = tile + temp.getBlockMapOffset();
 		if (canObstacleBePlacedHere(temp, obstaclePos)) //can be placed here
 		{
@@ -1601,7 +1615,7 @@ void CRmgTemplateZone::createObstacles2()
 	for (auto tile : boost::adaptors::reverse(tileinfo))
 	{
 		//fill tiles that should be blocked with obstacles or are just possible (with some probability)
-		if (gen->shouldBeBlocked(tile) || (gen->isPossible(tile) && gen->rand.nextInt(1,100) < 60))
+		if (gen->shouldBeBlocked(tile) || (gen->isPossible(tile) && rand.nextInt(1,100) < 60))
 		{
 			//start from biggets obstacles
 			for (int i = 0; i < possibleObstacles.size(); i++)
@@ -1677,22 +1691,30 @@ void CRmgTemplateZone::drawRoads()
 	}
 
 	gen->editManager->getTerrainSelection().setSelection(tiles);
-	gen->editManager->drawRoad(ERoadType::COBBLESTONE_ROAD, &gen->rand);
+	gen->editManager->drawRoad(ERoadType::COBBLESTONE_ROAD, &rand);
 }
 
 
-bool CRmgTemplateZone::fill()
+void CRmgTemplateZone::initContent()
 {
 	initTerrainType();
 
 	//zone center should be always clear to allow other tiles to connect
 	gen->setOccupied(pos, ETileType::FREE);
 	freePaths.insert(pos);
+}
 
-	addAllPossibleObjects ();
-
+void CRmgTemplateZone::createPaths()
+{
 	connectLater(); //ideally this should work after fractalize, but fails
 	fractalize();
+}
+
+bool CRmgTemplateZone::fill()
+{
+	//limits of prisons and seer huts depend on what previous zones have already used
+	addAllPossibleObjects ();
+
 	placeMines();
 	createRequiredObjects();
 	createTreasures();
@@ -1703,34 +1725,42 @@ bool CRmgTemplateZone::fill()
 
 bool CRmgTemplateZone::findPlaceForTreasurePile(float min_dist, int3 &pos, int value)
 {
-	float best_distance = 0;
 	bool result = false;
 
 	bool needsGuard = value > minGuardedValue;
 
 	//logGlobal->info("Min dist for density %f is %d", density, min_dist);
-	for(auto tile : possibleTiles)
+	//take tiles farthest from other objects first, until one has all neighbours available
+	std::vector<TDistance> checked;
+	while (!objectDistances.empty())
 	{
-		auto dist = gen->getNearestObjectDistance(tile);
+		TDistance entry = objectDistances.top();
+		objectDistances.pop();
+		if (isObjectDistanceOutdated(entry))
+			continue;
+
+		checked.push_back(entry);
+		if (entry.second < min_dist || entry.second <= 0)
+			break;
 
-		if ((dist >= min_dist) && (dist > best_distance))
+		bool allTilesAvailable = true;
+		gen->foreach_neighbour (entry.first, [this, &allTilesAvailable, needsGuard](int3 neighbour)
 		{
-			bool allTilesAvailable = true;
-			gen->foreach_neighbour (tile, [this, &allTilesAvailable, needsGuard](int3 neighbour)
-			{
-				if (!(gen->isPossible(neighbour) || gen->shouldBeBlocked(neighbour) || (!needsGuard && gen->isFree(neighbour))))
-				{
-					allTilesAvailable = false; //all present tiles must be already blocked or ready for new objects
-				}
-			});
-			if (allTilesAvailable)
+			if (!(gen->isPossible(neighbour) || gen->shouldBeBlocked(neighbour) || (!needsGuard && gen->isFree(neighbour))))
 			{
-				best_distance = dist;
-				pos = tile;
-				result = true;
+				allTilesAvailable = false; //all present tiles must be already blocked or ready for new objects
 			}
+		});
+		if (allTilesAvailable)
+		{
+			pos = entry.first;
+			result = true;
+			break;
 		}
 	}
+	for (auto & entry : checked) //tile stays in possible tiles, so keep it in the queue
+		objectDistances.push(entry);
+
 	if (result)
 	{
 		gen->setOccupied(pos, ETileType::BLOCKED); //block that tile //FIXME: why?
@@ -1738,6 +1768,19 @@ bool CRmgTemplateZone::findPlaceForTreasurePile(float min_dist, int3 &pos, int v
 	return result;
 }
 
+bool CRmgTemplateZone::isObjectDistanceOutdated(const TDistance & entry) const
+{
+	return !possibleTiles.contains(entry.first) || gen->getNearestObjectDistance(entry.first) != entry.second;
+}
+
+float CRmgTemplateZone::getMaxObjectDistance()
+{
+	while (!objectDistances.empty() && isObjectDistanceOutdated(objectDistances.top()))
+		objectDistances.pop();
+
+	return objectDistances.empty() ? 0 : objectDistances.top().second;
+}
+
 bool CRmgTemplateZone::canObstacleBePlacedHere(ObjectTemplate &temp, int3 &pos)
 {
 	if (!gen->map->isInTheMap(pos)) //blockmap may fit in the map, but botom-right corner does not
@@ -1824,7 +1867,8 @@ bool CRmgTemplateZone::findPlaceForObject(CGObjectInstance* obj, si32 min_dist,
 
 	auto tilesBlockedByObject = obj->getBlockedOffsets();
 
-	for (auto tile : tileinfo)
+	//tiles never become possible again, so all possible tiles of zone are there
+	for (auto tile : possibleTiles)
 	{
 		//object must be accessible from at least one surounding tile
 		if (!isAccessibleFromAnywhere(obj->appearance, tile))
@@ -1915,10 +1959,40 @@ void CRmgTemplateZone::placeObject(CGObjectInstance* object, const int3 &pos, bo
 
 void CRmgTemplateZone::updateDistances(const int3 & pos)
 {
-	for (auto tile : possibleTiles) //don't need to mark distance for not possible tiles
+	auto updateDistance = [this, &pos](int3 tile)
+	{
+		float d = pos.dist2dSQ(tile); //optimization, only relative distance is interesting
+		if (d < gen->getNearestObjectDistance(tile))
+		{
+			gen->setNearestObjectDistance(tile, d);
+			objectDistances.push(std::make_pair(tile, gen->getNearestObjectDistance(tile)));
+		}
+	};
+
+	//tiles farther than current maximum distance can't get closer to this object
+	const double radius = std::ceil(std::sqrt(getMaxObjectDistance()));
+	const int3 mapSize = possibleTiles.getMapSize();
+
+	if ((2 * radius + 1) * (2 * radius + 1) * mapSize.z >= possibleTiles.size())
 	{
-		ui32 d = pos.dist2dSQ(tile); //optimization, only relative distance is interesting
-		gen->setNearestObjectDistance(tile, std::min<float>(d, gen->getNearestObjectDistance(tile)));
+		for (auto tile : possibleTiles) //don't need to mark distance for not possible tiles
+			updateDistance(tile);
+	}
+	else
+	{
+		const int r = radius;
+		for (int z = 0; z < mapSize.z; z++) //z is ignored by dist2dSQ
+		{
+			for (int y = std::max(0, pos.y - r); y <= std::min(mapSize.y - 1, pos.y + r); y++)
+			{
+				for (int x = std::max(0, pos.x - r); x <= std::min(mapSize.x - 1, pos.x + r); x++)
+				{
+					int3 tile(x, y, z);
+					if (possibleTiles.contains(tile))
+						updateDistance(tile);
+				}
+			}
+		}
 	}
 }
 
@@ -2147,7 +2221,7 @@ ObjectInfo CRmgTemplateZone::getRandomObject(CTreasurePileInfo &info, ui32 desir
 	}
 	else
 	{
-		int r = gen->rand.nextInt (1, total);
+		int r = rand.nextInt (1, total);
 
 		//binary search = fastest
 		auto it = std::lower_bound(thresholds.begin(), thresholds.end(), r,
@@ -2218,7 +2292,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 					possibleHeroes.push_back(j);
 			}
 
-			auto hid = *RandomGeneratorUtil::nextItem(possibleHeroes, gen->rand);
+			auto hid = *RandomGeneratorUtil::nextItem(possibleHeroes, rand);
 			auto factory = VLC->objtypeh->getHandlerFor(Obj::PRISON, 0);
 			auto obj = (CGHeroInstance *) factory->create(ObjectTemplate());
 
@@ -2300,7 +2374,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 					out.push_back(spell->id);
 				}
 			}
-			auto a = CArtifactInstance::createScroll(RandomGeneratorUtil::nextItem(out, gen->rand)->toSpell());
+			auto a = CArtifactInstance::createScroll(RandomGeneratorUtil::nextItem(out, rand)->toSpell());
 			obj->storedArtifact = a;
 			return obj;
 		};
@@ -2408,7 +2482,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 					spells.push_back(spell);
 			}
 
-			RandomGeneratorUtil::randomShuffle(spells, gen->rand);
+			RandomGeneratorUtil::randomShuffle(spells, rand);
 			for (int j = 0; j < std::min<int>(12, spells.size()); j++)
 			{
 				obj->spells.push_back(spells[j]->id);
@@ -2438,7 +2512,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 					spells.push_back(spell);
 			}
 
-			RandomGeneratorUtil::randomShuffle(spells, gen->rand);
+			RandomGeneratorUtil::randomShuffle(spells, rand);
 			for (int j = 0; j < std::min<int>(15, spells.size()); j++)
 			{
 				obj->spells.push_back(spells[j]->id);
@@ -2466,7 +2540,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 				spells.push_back(spell);
 		}
 
-		RandomGeneratorUtil::randomShuffle(spells, gen->rand);
+		RandomGeneratorUtil::randomShuffle(spells, rand);
 		for (int j = 0; j < std::min<int>(60, spells.size()); j++)
 		{
 			obj->spells.push_back(spells[j]->id);
@@ -2499,7 +2573,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 		}
 		oi.maxPerZone = seerHutsPerType;
 
-		RandomGeneratorUtil::randomShuffle(creatures, gen->rand);
+		RandomGeneratorUtil::randomShuffle(creatures, rand);
 
 		auto generateArtInfo = [this](ArtifactID id) -> ObjectInfo
 		{
@@ -2524,7 +2598,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 			if (!creaturesAmount)
 				continue;
 
-			int randomAppearance = *RandomGeneratorUtil::nextItem(VLC->objtypeh->knownSubObjects(Obj::SEER_HUT), gen->rand);
+			int randomAppearance = *RandomGeneratorUtil::nextItem(VLC->objtypeh->knownSubObjects(Obj::SEER_HUT), rand);
 
 			oi.generateObject = [creature, creaturesAmount, randomAppearance, this, generateArtInfo]() -> CGObjectInstance *
 			{
@@ -2535,7 +2609,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 				obj->rVal = creaturesAmount;
 
 				obj->quest->missionType = CQuest::MISSION_ART;
-				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), gen->rand);
+				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), rand);
 				obj->quest->m5arts.push_back(artid);
 				obj->quest->lastDay = -1;
 				obj->quest->isCustomFirst = obj->quest->isCustomNext = obj->quest->isCustomComplete = false;
@@ -2557,7 +2631,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 
 		for (int i = 0; i < 4; i++) //seems that code for exp and gold reward is similiar
 		{
-			int randomAppearance = *RandomGeneratorUtil::nextItem(VLC->objtypeh->knownSubObjects(Obj::SEER_HUT), gen->rand);
+			int randomAppearance = *RandomGeneratorUtil::nextItem(VLC->objtypeh->knownSubObjects(Obj::SEER_HUT), rand);
 
 			oi.setTemplate(Obj::SEER_HUT, randomAppearance, terrainType);
 			oi.value = seerValues[i];
@@ -2573,7 +2647,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 				obj->rVal = seerExpGold[i];
 
 				obj->quest->missionType = CQuest::MISSION_ART;
-				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), gen->rand);
+				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), rand);
 				obj->quest->m5arts.push_back(artid);
 				obj->quest->lastDay = -1;
 				obj->quest->isCustomFirst = obj->quest->isCustomNext = obj->quest->isCustomComplete = false;
@@ -2596,7 +2670,7 @@ void CRmgTemplateZone::addAllPossibleObjects()
 				obj->rVal = seerExpGold[i];
 
 				obj->quest->missionType = CQuest::MISSION_ART;
-				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), gen->rand);
+				ArtifactID artid = *RandomGeneratorUtil::nextItem(gen->getQuestArtsRemaning(), rand);
 				obj->quest->m5arts.push_back(artid);
 				obj->quest->lastDay = -1;
 				obj->quest->isCustomFirst = obj->quest->isCustomNext = obj->quest->isCustomComplete = false;
@@ -16,6 +16,7 @@
 #include "../int3.h"
 #include "CRmgTemplate.h"
 #include "../mapObjects/ObjectTemplate.h"
+#include "CTileSet.h"
 #include <boost/heap/priority_queue.hpp> //A*
 
 class CMapGenerator;
@@ -94,6 +95,7 @@ public:
 	void setOptions(const rmg::ZoneOptions * options);
 
 	void setGenPtr(CMapGenerator * Gen);
+	void setRandomSeed(int seed);
 
 	float3 getCenter() const;
 	void setCenter(const float3 &f);
@@ -104,8 +106,8 @@ public:
 
 	void addTile (const int3 &pos);
 	void initFreeTiles ();
-	std::set<int3> getTileInfo() const;
-	std::set<int3> getPossibleTiles() const;
+	const CTileSet & getTileInfo() const;
+	const CTileSet & getPossibleTiles() const;
 	void discardDistantTiles (float distance);
 	void clearTiles();
 
@@ -114,7 +116,9 @@ public:
 	void addToConnectLater(const int3& src);
 	bool addMonster(int3 &pos, si32 strength, bool clearSurroundingTiles = true, bool zoneGuard = false);
 	bool createTreasurePile(int3 &pos, float minDistance, const CTreasureInfo& treasureInfo);
-	bool fill ();
+	void initContent(); //terrain and free zone center
+	void createPaths(); //reads and modifies only tiles of this zone, so different zones can do it in parallel
+	bool fill (); //mines, required objects and treasures
 	bool placeMines ();
 	void initTownType ();
 	void paintZoneTerrain (ETerrainType terrainType);
@@ -128,7 +132,7 @@ public:
 	void createTreasures();
 	void createObstacles1();
 	void createObstacles2();
-	bool crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, std::set<int3>* clearedTiles = nullptr);
+	bool crunchPath(const int3 &src, const int3 &dst, bool onlyStraight, CTileSet* clearedTiles = nullptr);
 	bool connectPath(const int3& src, bool onlyStraight);
 	bool connectWithCenter(const int3& src, bool onlyStraight);
 	void updateDistances(const int3 & pos);
@@ -137,7 +141,7 @@ public:
 	bool areAllTilesAvailable(CGObjectInstance* obj, int3& tile, std::set<int3>& tilesBlockedByObject) const;
 
 	void setQuestArtZone(std::shared_ptr<CRmgTemplateZone> otherZone);
-	std::set<int3>* getFreePaths();
+	CTileSet* getFreePaths();
 
 	ObjectInfo getRandomObject (CTreasurePileInfo &info, ui32 desiredValue, ui32 maxValue, ui32 currentValue);
 
@@ -159,8 +163,20 @@ public:
 	};
 	boost::heap::priority_queue<TDistance, boost::heap::compare<NodeComparer>> createPiorityQueue();
 
+	//farthest from objects first, ties in the same order as tiles are iterated
+	struct ObjectDistanceComparer
+	{
+		bool operator()(const TDistance & lhs, const TDistance & rhs) const
+		{
+			if (lhs.second != rhs.second)
+				return lhs.second < rhs.second;
+			return rhs.first < lhs.first;
+		}
+	};
+
 private:
 	CMapGenerator * gen;
+	CRandomGenerator rand; //own stream, so zone content does not depend on order in which zones are processed
 	//template info
 
 	si32 townType;
@@ -178,14 +194,19 @@ private:
 	//placement info
 	int3 pos;
 	float3 center;
-	std::set<int3> tileinfo; //irregular area assined to zone
-	std::set<int3> possibleTiles; //optimization purposes for treasure generation
-	std::set<int3> freePaths; //core paths of free tiles that all other objects will be linked to
+	CTileSet tileinfo; //irregular area assined to zone
+	CTileSet possibleTiles; //optimization purposes for treasure generation
+	CTileSet freePaths; //core paths of free tiles that all other objects will be linked to
 
 	std::set<int3> roadNodes; //tiles to be connected with roads
-	std::set<int3> roads; //all tiles with roads
-	std::set<int3> tilesToConnectLater; //will be connected after paths are fractalized
+	CTileSet roads; //all tiles with roads
+	CTileSet tilesToConnectLater; //will be connected after paths are fractalized
+
+	//nearest object distance of possible tiles, entry is outdated if tile is no longer possible or distance has changed
+	boost::heap::priority_queue<TDistance, boost::heap::compare<ObjectDistanceComparer>> objectDistances;
 
+	/// Scratch data of A* searches, one whole-map buffer per thread shared by all zones it works on
+	CTileSearchBuffer & getSearchBuffer() const;
 	bool createRoad(const int3 &src, const int3 &dst);
 	void drawRoads(); //actually updates tiles
 
@@ -193,6 +214,8 @@ private:
 	void addAllPossibleObjects (); //add objects, including zone-specific, to possibleObjects
 	bool findPlaceForObject(CGObjectInstance* obj, si32 min_dist, int3 &pos);
 	bool findPlaceForTreasurePile(float min_dist, int3 &pos, int value);
+	bool isObjectDistanceOutdated(const TDistance & entry) const;
+	float getMaxObjectDistance(); //of possible tiles, also drops outdated entries from the top of the queue
 	bool canObstacleBePlacedHere(ObjectTemplate &temp, int3 &pos);
 	void setTemplateForObject(CGObjectInstance* obj);
 	void checkAndPlaceObject(CGObjectInstance* object, const int3 &pos);
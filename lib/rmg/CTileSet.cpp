@@ -0,0 +1,282 @@
+/*
+ * CTileSet.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "CTileSet.h"
+
+static const float NO_DISTANCE = std::numeric_limits<float>::max();
+
+CTileSet::CTileSet()
+	: mapSize(0, 0, 0), tilesCount(0), hasErased(false), unsorted(false)
+{
+}
+
+CTileSet::CTileSet(const int3 & mapSize)
+	: CTileSet()
+{
+	resize(mapSize);
+}
+
+void CTileSet::resize(const int3 & size)
+{
+	mapSize = size;
+	present.assign(mapSize.x * mapSize.y * mapSize.z, false);
+	tiles.clear();
+	tilesCount = 0;
+	hasErased = false;
+	unsorted = false;
+}
+
+const int3 & CTileSet::getMapSize() const
+{
+	return mapSize;
+}
+
+size_t CTileSet::getIndex(const int3 & tile) const
+{
+	assert(tile.x >= 0 && tile.y >= 0 && tile.z >= 0);
+	assert(tile.x < mapSize.x && tile.y < mapSize.y && tile.z < mapSize.z);
+	//same order as int3::operator<
+	return (tile.z * mapSize.y + tile.y) * mapSize.x + tile.x;
+}
+
+bool CTileSet::insert(const int3 & tile)
+{
+	auto index = getIndex(tile);
+	if(present[index])
+		return false;
+
+	//erased copy of this tile may still be in the list
+	if(hasErased)
+		normalize();
+
+	present[index] = true;
+	tilesCount++;
+
+	if(!tiles.empty() && tile < tiles.back())
+		unsorted = true;
+	tiles.push_back(tile);
+	return true;
+}
+
+bool CTileSet::erase(const int3 & tile)
+{
+	auto index = getIndex(tile);
+	if(!present[index])
+		return false;
+
+	present[index] = false;
+	tilesCount--;
+	hasErased = true;
+	return true;
+}
+
+bool CTileSet::contains(const int3 & tile) const
+{
+	return present[getIndex(tile)];
+}
+
+size_t CTileSet::count(const int3 & tile) const
+{
+	return contains(tile) ? 1 : 0;
+}
+
+void CTileSet::clear()
+{
+	for(auto & tile : tiles)
+		present[getIndex(tile)] = false;
+	tiles.clear();
+	tilesCount = 0;
+	hasErased = false;
+	unsorted = false;
+}
+
+size_t CTileSet::size() const
+{
+	return tilesCount;
+}
+
+bool CTileSet::empty() const
+{
+	return tilesCount == 0;
+}
+
+void CTileSet::normalize() const
+{
+	if(hasErased)
+	{
+		vstd::erase_if(tiles, [this](const int3 & tile)
+		{
+			return !present[getIndex(tile)];
+		});
+		hasErased = false;
+	}
+	if(unsorted)
+	{
+		boost::sort(tiles);
+		unsorted = false;
+	}
+}
+
+CTileSet::const_iterator CTileSet::begin() const
+{
+	normalize();
+	return tiles.begin();
+}
+
+CTileSet::const_iterator CTileSet::end() const
+{
+	normalize();
+	return tiles.end();
+}
+
+CTileBuckets::CTileBuckets(const int3 & mapSize, int cellSize)
+	: cellSize(cellSize),
+	columns((mapSize.x + cellSize - 1) / cellSize),
+	rows((mapSize.y + cellSize - 1) / cellSize),
+	cells(columns * rows)
+{
+	assert(cellSize > 0);
+}
+
+void CTileBuckets::insert(const int3 & tile)
+{
+	assert(tile.x >= 0 && tile.y >= 0);
+	cells[(tile.y / cellSize) * columns + tile.x / cellSize].push_back(tile);
+}
+
+bool CTileBuckets::hasTileWithin(const int3 & tile, ui32 maxDistanceSQ) const
+{
+	int radius = std::sqrt(maxDistanceSQ);
+	while((ui32)((radius + 1) * (radius + 1)) <= maxDistanceSQ) //guard against rounding
+		radius++;
+
+	//z is ignored, like in dist2dSQ
+	const int minColumn = std::max(0, (tile.x - radius) / cellSize);
+	const int maxColumn = std::min(columns - 1, (tile.x + radius) / cellSize);
+	const int minRow = std::max(0, (tile.y - radius) / cellSize);
+	const int maxRow = std::min(rows - 1, (tile.y + radius) / cellSize);
+
+	for(int row = minRow; row <= maxRow; row++)
+	{
+		for(int column = minColumn; column <= maxColumn; column++)
+		{
+			for(const int3 & other : cells[row * columns + column])
+			{
+				if(tile.dist2dSQ(other) <= maxDistanceSQ)
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+CTileSearchBuffer::CTileSearchBuffer()
+	: mapSize(0, 0, 0), currentStamp(1)
+{
+}
+
+void CTileSearchBuffer::resize(const int3 & size)
+{
+	mapSize = size;
+	const size_t tilesCount = mapSize.x * mapSize.y * mapSize.z;
+	closedStamps.assign(tilesCount, 0);
+	visitedStamps.assign(tilesCount, 0);
+	distances.assign(tilesCount, NO_DISTANCE);
+	cameFrom.assign(tilesCount, int3(-1, -1, -1));
+	closed.clear();
+	currentStamp = 1;
+}
+
+const int3 & CTileSearchBuffer::getMapSize() const
+{
+	return mapSize;
+}
+
+void CTileSearchBuffer::reset()
+{
+	closed.clear();
+	currentStamp++;
+	if(currentStamp == 0) //wrapped around, old stamps may match again
+	{
+		boost::fill(closedStamps, 0);
+		boost::fill(visitedStamps, 0);
+		currentStamp = 1;
+	}
+}
+
+size_t CTileSearchBuffer::getIndex(const int3 & tile) const
+{
+	assert(tile.x >= 0 && tile.y >= 0 && tile.z >= 0);
+	assert(tile.x < mapSize.x && tile.y < mapSize.y && tile.z < mapSize.z);
+	return (tile.z * mapSize.y + tile.y) * mapSize.x + tile.x;
+}
+
+bool CTileSearchBuffer::isClosed(const int3 & tile) const
+{
+	return closedStamps[getIndex(tile)] == currentStamp;
+}
+
+void CTileSearchBuffer::close(const int3 & tile)
+{
+	auto index = getIndex(tile);
+	if(closedStamps[index] != currentStamp)
+	{
+		closedStamps[index] = currentStamp;
+		closed.push_back(tile);
+	}
+}
+
+const std::vector<int3> & CTileSearchBuffer::getClosed() const
+{
+	return closed;
+}
+
+bool CTileSearchBuffer::hasDistance(const int3 & tile) const
+{
+	auto index = getIndex(tile);
+	return visitedStamps[index] == currentStamp && distances[index] != NO_DISTANCE;
+}
+
+float CTileSearchBuffer::getDistance(const int3 & tile) const
+{
+	assert(hasDistance(tile));
+	return distances[getIndex(tile)];
+}
+
+void CTileSearchBuffer::setDistance(const int3 & tile, float distance)
+{
+	auto index = getIndex(tile);
+	if(visitedStamps[index] != currentStamp)
+	{
+		visitedStamps[index] = currentStamp;
+		cameFrom[index] = int3(-1, -1, -1);
+	}
+	distances[index] = distance;
+}
+
+int3 CTileSearchBuffer::getCameFrom(const int3 & tile) const
+{
+	auto index = getIndex(tile);
+	if(visitedStamps[index] != currentStamp)
+		return int3(-1, -1, -1);
+	return cameFrom[index];
+}
+
+void CTileSearchBuffer::setCameFrom(const int3 & tile, const int3 & from)
+{
+	auto index = getIndex(tile);
+	if(visitedStamps[index] != currentStamp)
+	{
+		visitedStamps[index] = currentStamp;
+		distances[index] = NO_DISTANCE;
+	}
+	cameFrom[index] = from;
+}
@@ -0,0 +1,120 @@
+/*
+ * CTileSet.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../int3.h"
+
+/// Set of map tiles backed by a bitmap of the whole map, so lookups and changes are O(1).
+/// Tiles are iterated in the same order as std::set<int3>. Iterators are invalidated
+/// by any insertion or removal.
+class DLL_LINKAGE CTileSet
+{
+public:
+	typedef int3 value_type;
+	typedef std::vector<int3>::const_iterator const_iterator;
+	typedef const_iterator iterator;
+
+	CTileSet();
+	/// mapSize is width, height and number of levels
+	explicit CTileSet(const int3 & mapSize);
+
+	void resize(const int3 & mapSize); //also removes all tiles
+	const int3 & getMapSize() const;
+
+	bool insert(const int3 & tile); //returns false if tile was already present
+	bool erase(const int3 & tile); //returns false if tile was not present
+	bool contains(const int3 & tile) const;
+	size_t count(const int3 & tile) const;
+	void clear();
+
+	/// Removes tiles matching predicate; predicate is called once per tile, in iteration order
+	template<typename Predicate>
+	void eraseIf(Predicate pred)
+	{
+		//erase only clears the bitmap, so iterating the list meanwhile is safe
+		for(const int3 & tile : *this)
+		{
+			if(pred(tile))
+				erase(tile);
+		}
+	}
+
+	size_t size() const;
+	bool empty() const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	int3 mapSize;
+	std::vector<bool> present;
+	size_t tilesCount;
+
+	//may contain erased tiles or be unsorted until next iteration
+	mutable std::vector<int3> tiles;
+	mutable bool hasErased;
+	mutable bool unsorted;
+
+	size_t getIndex(const int3 & tile) const;
+	void normalize() const;
+};
+
+/// Tiles bucketed by square cells of the map, for proximity queries on Oxy plane.
+/// Supports insertion only, the same tile may be added more than once.
+class DLL_LINKAGE CTileBuckets
+{
+public:
+	CTileBuckets(const int3 & mapSize, int cellSize);
+
+	void insert(const int3 & tile);
+	/// True if any tile has dist2dSQ to given one not greater than maxDistanceSQ
+	bool hasTileWithin(const int3 & tile, ui32 maxDistanceSQ) const;
+
+private:
+	int cellSize;
+	int columns;
+	int rows;
+	std::vector<std::vector<int3>> cells;
+};
+
+/// Per-tile scratch data for A* searches over the map. Reset is O(1) so the same buffer
+/// can be reused by all searches of a thread without allocating nodes.
+class DLL_LINKAGE CTileSearchBuffer
+{
+public:
+	CTileSearchBuffer();
+
+	void resize(const int3 & mapSize);
+	const int3 & getMapSize() const;
+	void reset(); //forgets all tiles
+
+	bool isClosed(const int3 & tile) const;
+	void close(const int3 & tile);
+	const std::vector<int3> & getClosed() const; //in order of closing
+
+	bool hasDistance(const int3 & tile) const;
+	float getDistance(const int3 & tile) const; //tile must have distance
+	void setDistance(const int3 & tile, float distance);
+
+	int3 getCameFrom(const int3 & tile) const; //invalid tile if not set
+	void setCameFrom(const int3 & tile, const int3 & from);
+
+private:
+	int3 mapSize;
+	ui32 currentStamp;
+	std::vector<ui32> closedStamps;
+	std::vector<ui32> visitedStamps; //distance and cameFrom are valid for current stamp only
+	std::vector<float> distances;
+	std::vector<int3> cameFrom;
+	std::vector<int3> closed;
+
+	size_t getIndex(const int3 & tile) const;
+};
@@ -35,11 +35,6 @@ int3 CZonePlacer::cords (const float3 f) const
 	return int3(std::max(0.f, (f.x * gen->map->width)-1), std::max(0.f, (f.y * gen->map->height-1)), f.z);
 }
 
-float CZonePlacer::getDistance (float distance) const
-{
-	return (distance ? distance * distance : 1e-6);
-}
-
 void CZonePlacer::placeZones(const CMapGenOptions * mapGenOptions, CRandomGenerator * rand)
 {
 	logGlobal->info("Starting zone placement");
@@ -68,53 +63,31 @@ void CZonePlacer::placeZones(const CMapGenOptions * mapGenOptions, CRandomGenera
 	prepareZones(zones, zonesVector, underground, rand);
 
 	//gravity-based algorithm. connected zones attract, intersceting zones and map boundaries push back
+	CZoneLayout layout(mapSize, gravityConstant, stiffnessConstant);
+	std::map<TRmgTemplateZoneId, int> indices;
+	for (auto zone : zones)
+		indices[zone.first] = layout.addZone(zone.second->getCenter(), zone.second->getSize());
+	for (auto zone : zones)
+	{
+		for (auto con : zone.second->getConnections())
+			layout.addConnection(indices[zone.first], indices.at(con));
+	}
 
 	//remember best solution
 	float bestTotalDistance = 1e10;
 	float bestTotalOverlap = 1e10;
 
-	std::map<std::shared_ptr<CRmgTemplateZone>, float3> bestSolution;
-
-	TForceVector forces;
-	TForceVector totalForces; //  both attraction and pushback, overcomplicated?
-	TDistanceVector distances;
-	TDistanceVector overlaps;
+	std::vector<float3> bestSolution(layout.getZoneCount());
 
 	const int MAX_ITERATIONS = 100;
-	for (int i = 0; i < MAX_ITERATIONS; ++i) //until zones reach their desired size and fill the map tightly
+	const float CONVERGENCE_THRESHOLD = 1e-6f; //zones moved less than that in total, layout is at rest
+	int iteration = 0;
+	for (; iteration < MAX_ITERATIONS; ++iteration) //until zones reach their desired size and fill the map tightly
 	{
-		//1. attract connected zones
-		attractConnectedZones(zones, forces, distances);
-		for (auto zone : forces)
-		{
-			zone.first->setCenter (zone.first->getCenter() + zone.second);
-			totalForces[zone.first] = zone.second; //override
-		}
+		float movement = layout.iterate();
 
-		//2. separate overlapping zones
-		separateOverlappingZones(zones, forces, overlaps);
-		for (auto zone : forces)
-		{
-			zone.first->setCenter (zone.first->getCenter() + zone.second);
-			totalForces[zone.first] += zone.second; //accumulate
-		}
-
-		//3. now perform drastic movement of zone that is completely not linked
-
-		moveOneZone(zones, totalForces, distances, overlaps);
-
-		//4. NOW after everything was moved, re-evaluate zone positions
-		attractConnectedZones(zones, forces, distances);
-		separateOverlappingZones(zones, forces, overlaps);
-
-		float totalDistance = 0;
-		float totalOverlap = 0;
-		for (auto zone : distances) //find most misplaced zone
-		{
-			totalDistance += zone.second;
-			float overlap = overlaps[zone.first];
-			totalOverlap += overlap;
-		}
+		float totalDistance = layout.getTotalDistance();
+		float totalOverlap = layout.getTotalOverlap();
 
 		//check fitness function
 		bool improvement = false;
@@ -137,15 +110,20 @@ void CZonePlacer::placeZones(const CMapGenOptions * mapGenOptions, CRandomGenera
 			bestTotalDistance = totalDistance;
 			bestTotalOverlap = totalOverlap;
 
-			for (auto zone : zones)
-				bestSolution[zone.second] = zone.second->getCenter();
+			for (int i = 0; i < layout.getZoneCount(); i++)
+				bestSolution[i] = layout.getCenter(i);
 		}
+
+		//nothing can be better than no distance and no overlap, and layout at rest won't change anymore
+		if ((bestTotalDistance == 0 && bestTotalOverlap == 0) || movement < CONVERGENCE_THRESHOLD)
+			break;
 	}
 
-	logGlobal->trace("Best fitness reached: total distance %2.4f, total overlap %2.4f", bestTotalDistance, bestTotalOverlap);
+	logGlobal->trace("Best fitness reached after %d iterations: total distance %2.4f, total overlap %2.4f", iteration, bestTotalDistance, bestTotalOverlap);
 	for (auto zone : zones) //finalize zone positions
 	{
-		zone.second->setPos (cords (bestSolution[zone.second]));
+		zone.second->setCenter (bestSolution[indices[zone.first]]);
+		zone.second->setPos (cords (zone.second->getCenter()));
 		logGlobal->trace("Placed zone %d at relative position %s and coordinates %s", zone.first, zone.second->getCenter().toString(), zone.second->getPos().toString());
 	}
 }
@@ -258,179 +236,296 @@ void CZonePlacer::prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const
 	}
 }
 
-void CZonePlacer::attractConnectedZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &distances)
+CZoneLayout::CZoneLayout(float mapSize, float gravityConstant, float stiffnessConstant)
+	: mapSize(mapSize), gravityConstant(gravityConstant), stiffnessConstant(stiffnessConstant)
 {
-	for (auto zone : zones)
+}
+
+int CZoneLayout::addZone(const float3 & center, float zoneSize)
+{
+	x.push_back(center.x);
+	y.push_back(center.y);
+	level.push_back(center.z);
+	size.push_back(zoneSize);
+	connections.push_back(std::vector<int>());
+
+	const size_t count = x.size();
+	forceX.resize(count);
+	forceY.resize(count);
+	totalForceX.resize(count);
+	totalForceY.resize(count);
+	distances.resize(count);
+	overlaps.resize(count);
+
+	return count - 1;
+}
+
+void CZoneLayout::addConnection(int zone, int otherZone)
+{
+	connections.at(zone).push_back(otherZone);
+}
+
+int CZoneLayout::getZoneCount() const
+{
+	return x.size();
+}
+
+float3 CZoneLayout::getCenter(int zone) const
+{
+	return float3(x[zone], y[zone], level[zone]);
+}
+
+void CZoneLayout::setCenter(int zone, const float3 & center)
+{
+	x[zone] = center.x;
+	y[zone] = center.y;
+	level[zone] = center.z;
+}
+
+float CZoneLayout::getDistance(float distance)
+{
+	return (distance ? distance * distance : 1e-6);
+}
+
+float CZoneLayout::distanceBetween(int zone, int otherZone) const
+{
+	const double dx = x[zone] - x[otherZone];
+	const double dy = y[zone] - y[otherZone];
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+float CZoneLayout::iterate()
+{
+	const int count = getZoneCount();
+	std::vector<float> oldX(x), oldY(y);
+
+	//1. attract connected zones
+	attractConnectedZones();
+	applyForces();
+	totalForceX = forceX; //override
+	totalForceY = forceY;
+
+	//2. separate overlapping zones
+	separateOverlappingZones();
+	applyForces();
+	for (int i = 0; i < count; i++) //accumulate
+	{
+		totalForceX[i] += forceX[i];
+		totalForceY[i] += forceY[i];
+	}
+
+	//3. now perform drastic movement of zone that is completely not linked
+	moveOneZone();
+
+	//4. NOW after everything was moved, re-evaluate zone positions
+	attractConnectedZones();
+	separateOverlappingZones();
+
+	float movement = 0;
+	for (int i = 0; i < count; i++)
+		movement += std::abs(x[i] - oldX[i]) + std::abs(y[i] - oldY[i]);
+	return movement;
+}
+
+float CZoneLayout::getTotalDistance() const
+{
+	return std::accumulate(distances.begin(), distances.end(), 0.f);
+}
+
+float CZoneLayout::getTotalOverlap() const
+{
+	return std::accumulate(overlaps.begin(), overlaps.end(), 0.f);
+}
+
+void CZoneLayout::attractConnectedZones()
+{
+	const int count = getZoneCount();
+	for (int i = 0; i < count; i++)
 	{
-		float3 forceVector(0, 0, 0);
-		float3 pos = zone.second->getCenter();
+		float fx = 0, fy = 0;
 		float totalDistance = 0;
 
-		for (auto con : zone.second->getConnections())
+		for (int j : connections[i])
 		{
-			auto otherZone = zones[con];
-			float3 otherZoneCenter = otherZone->getCenter();
-			float distance = pos.dist2d(otherZoneCenter);
+			float distance = distanceBetween(i, j);
 			float minDistance = 0;
 
-			if (pos.z != otherZoneCenter.z)
+			if (level[i] != level[j])
 				minDistance = 0; //zones on different levels can overlap completely
 			else
-				minDistance = (zone.second->getSize() + otherZone->getSize()) / mapSize; //scale down to (0,1) coordinates
+				minDistance = (size[i] + size[j]) / mapSize; //scale down to (0,1) coordinates
 
 			if (distance > minDistance)
 			{
-				//WARNING: compiler used to 'optimize' that line so it never actually worked
-				float overlapMultiplier = (pos.z == otherZoneCenter.z) ? (minDistance / distance) : 1.0f;
-				forceVector += ((otherZoneCenter - pos)* overlapMultiplier / getDistance(distance)) * gravityConstant; //positive value
+				float overlapMultiplier = (level[i] == level[j]) ? (minDistance / distance) : 1.0f;
+				const float divisor = getDistance(distance);
+				fx += ((x[j] - x[i]) * overlapMultiplier / divisor) * gravityConstant; //positive value
+				fy += ((y[j] - y[i]) * overlapMultiplier / divisor) * gravityConstant;
 				totalDistance += (distance - minDistance);
 			}
 		}
-		distances[zone.second] = totalDistance;
-		forceVector.z = 0; //operator - doesn't preserve z coordinate :/
-		forces[zone.second] = forceVector;
+		distances[i] = totalDistance;
+		forceX[i] = fx;
+		forceY[i] = fy;
 	}
 }
 
-void CZonePlacer::separateOverlappingZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &overlaps)
+void CZoneLayout::separateOverlappingZones()
 {
-	for (auto zone : zones)
+	const int count = getZoneCount();
+	for (int i = 0; i < count; i++)
 	{
-		float3 forceVector(0, 0, 0);
-		float3 pos = zone.second->getCenter();
-
+		const float px = x[i], py = y[i];
+		const float ownSize = size[i];
+		const si32 ownLevel = level[i];
+		float fx = 0, fy = 0;
 		float overlap = 0;
-		//separate overlaping zones
-		for (auto otherZone : zones)
+
+		//separate overlaping zones, plain loop over arrays without indirection
+		for (int j = 0; j < count; j++)
 		{
-			float3 otherZoneCenter = otherZone.second->getCenter();
 			//zones on different levels don't push away
-			if (zone == otherZone || pos.z != otherZoneCenter.z)
+			if (j == i || level[j] != ownLevel)
 				continue;
 
-			float distance = pos.dist2d(otherZoneCenter);
-			float minDistance = (zone.second->getSize() + otherZone.second->getSize()) / mapSize;
+			const float distance = distanceBetween(i, j);
+			const float minDistance = (ownSize + size[j]) / mapSize;
 			if (distance < minDistance)
 			{
-				forceVector -= (((otherZoneCenter - pos)*(minDistance / (distance ? distance : 1e-3))) / getDistance(distance)) * stiffnessConstant; //negative value
+				const float multiplier = minDistance / (distance ? distance : 1e-3);
+				const float divisor = getDistance(distance);
+				fx -= (((x[j] - px) * multiplier) / divisor) * stiffnessConstant; //negative value
+				fy -= (((y[j] - py) * multiplier) / divisor) * stiffnessConstant;
 				overlap += (minDistance - distance); //overlapping of small zones hurts us more
 			}
 		}
 
 		//move zones away from boundaries
 		//do not scale boundary distance - zones tend to get squashed
-		float size = zone.second->getSize() / mapSize;
+		float zoneSize = ownSize / mapSize;
 
-		auto pushAwayFromBoundary = [&forceVector, pos, size, &overlap, this](float x, float y)
+		auto pushAwayFromBoundary = [&](float bx, float by)
 		{
-			float3 boundary = float3(x, y, pos.z);
-			float distance = pos.dist2d(boundary);
-			overlap += std::max<float>(0, distance - size); //check if we're closer to map boundary than value of zone size
-			forceVector -= (boundary - pos) * (size - distance) / this->getDistance(distance) * this->stiffnessConstant; //negative value
+			const double dx = px - bx;
+			const double dy = py - by;
+			float distance = std::sqrt(dx * dx + dy * dy);
+			overlap += std::max<float>(0, distance - zoneSize); //check if we're closer to map boundary than value of zone size
+			const float divisor = getDistance(distance);
+			fx -= (((bx - px) * (zoneSize - distance)) / divisor) * stiffnessConstant; //negative value
+			fy -= (((by - py) * (zoneSize - distance)) / divisor) * stiffnessConstant;
 		};
-		if (pos.x < size)
+		if (px < zoneSize)
 		{
-			pushAwayFromBoundary(0, pos.y);
+			pushAwayFromBoundary(0, py);
 		}
-		if (pos.x > 1 - size)
+		if (px > 1 - zoneSize)
 		{
-			pushAwayFromBoundary(1, pos.y);
+			pushAwayFromBoundary(1, py);
 		}
-		if (pos.y < size)
+		if (py < zoneSize)
 		{
-			pushAwayFromBoundary(pos.x, 0);
+			pushAwayFromBoundary(px, 0);
 		}
-		if (pos.y > 1 - size)
+		if (py > 1 - zoneSize)
 		{
-			pushAwayFromBoundary(pos.x, 1);
+			pushAwayFromBoundary(px, 1);
 		}
-		overlaps[zone.second] = overlap;
-		forceVector.z = 0; //operator - doesn't preserve z coordinate :/
-		forces[zone.second] = forceVector;
+		overlaps[i] = overlap;
+		forceX[i] = fx;
+		forceY[i] = fy;
+	}
+}
+
+void CZoneLayout::applyForces()
+{
+	const int count = getZoneCount();
+	for (int i = 0; i < count; i++)
+	{
+		x[i] += forceX[i];
+		y[i] += forceY[i];
 	}
 }
 
-void CZonePlacer::moveOneZone(TZoneMap &zones, TForceVector &totalForces, TDistanceVector &distances, TDistanceVector &overlaps)
+bool CZoneLayout::moveOneZone()
 {
+	const int count = getZoneCount();
 	float maxRatio = 0;
-	const int maxDistanceMovementRatio = zones.size() * zones.size(); //experimental - the more zones, the greater total distance expected
-	std::shared_ptr<CRmgTemplateZone> misplacedZone;
+	const int maxDistanceMovementRatio = count * count; //experimental - the more zones, the greater total distance expected
+	int misplacedZone = -1;
 
 	float totalDistance = 0;
 	float totalOverlap = 0;
-	for (auto zone : distances) //find most misplaced zone
+	for (int i = 0; i < count; i++) //find most misplaced zone
 	{
-		totalDistance += zone.second;
-		float overlap = overlaps[zone.first];
-		totalOverlap += overlap;
-		float ratio = (zone.second + overlap) / totalForces[zone.first].mag(); //if distance to actual movement is long, the zone is misplaced
+		totalDistance += distances[i];
+		totalOverlap += overlaps[i];
+		float movement = std::sqrt(totalForceX[i] * totalForceX[i] + totalForceY[i] * totalForceY[i]);
+		float ratio = (distances[i] + overlaps[i]) / movement; //if distance to actual movement is long, the zone is misplaced
 		if (ratio > maxRatio)
 		{
 			maxRatio = ratio;
-			misplacedZone = zone.first;
+			misplacedZone = i;
 		}
 	}
 	logGlobal->trace("Worst misplacement/movement ratio: %3.2f", maxRatio);
 
-	if (maxRatio > maxDistanceMovementRatio && misplacedZone)
-	{
-		std::shared_ptr<CRmgTemplateZone> targetZone;
-		float3 ourCenter = misplacedZone->getCenter();
+	if (maxRatio <= maxDistanceMovementRatio || misplacedZone < 0)
+		return false;
+
+	const int i = misplacedZone;
+	int targetZone = -1;
+	float targetDistance = 0;
 
-		if (totalDistance > totalOverlap)
+	if (totalDistance > totalOverlap)
+	{
+		//find most distant zone that should be attracted and move inside it
+		for (int j : connections[i])
 		{
-			//find most distant zone that should be attracted and move inside it
-			float maxDistance = 0;
-			for (auto con : misplacedZone->getConnections())
-			{
-				auto otherZone = zones[con];
-				float distance = otherZone->getCenter().dist2dSQ(ourCenter);
-				if (distance > maxDistance)
-				{
-					maxDistance = distance;
-					targetZone = otherZone;
-				}
-			}
-			if (targetZone) //TODO: consider refactoring duplicated code
+			float distance = distanceBetween(i, j);
+			if (distance > targetDistance)
 			{
-				float3 vec = targetZone->getCenter() - ourCenter;
-				float newDistanceBetweenZones = (std::max(misplacedZone->getSize(), targetZone->getSize())) / mapSize;
-				logGlobal->trace("Trying to move zone %d %s towards %d %s. Old distance %f", misplacedZone->getId(), ourCenter.toString(), targetZone->getId(), targetZone->getCenter().toString(), maxDistance);
-				logGlobal->trace("direction is %s", vec.toString());
-
-				misplacedZone->setCenter(targetZone->getCenter() - vec.unitVector() * newDistanceBetweenZones); //zones should now overlap by half size
-				logGlobal->trace("New distance %f", targetZone->getCenter().dist2d(misplacedZone->getCenter()));
+				targetDistance = distance;
+				targetZone = j;
 			}
 		}
-		else
+	}
+	else
+	{
+		//find most distant zone on the same level and move away from it
+		for (int j = 0; j < count; j++)
 		{
-			float maxOverlap = 0;
-			for (auto otherZone : zones)
-			{
-				float3 otherZoneCenter = otherZone.second->getCenter();
-
-				if (otherZone.second == misplacedZone || otherZoneCenter.z != ourCenter.z)
-					continue;
+			if (j == i || level[j] != level[i])
+				continue;
 
-				float distance = otherZoneCenter.dist2dSQ(ourCenter);
-				if (distance > maxOverlap)
-				{
-					maxOverlap = distance;
-					targetZone = otherZone.second;
-				}
-			}
-			if (targetZone)
+			float distance = distanceBetween(i, j);
+			if (distance > targetDistance)
 			{
-				float3 vec = ourCenter - targetZone->getCenter();
-				float newDistanceBetweenZones = (misplacedZone->getSize() + targetZone->getSize()) / mapSize;
-				logGlobal->trace("Trying to move zone %d %s away from %d %s. Old distance %f", misplacedZone->getId(), ourCenter.toString(), targetZone->getId(), targetZone->getCenter().toString(), maxOverlap);
-				logGlobal->trace("direction is %s", vec.toString());
-
-				misplacedZone->setCenter(targetZone->getCenter() + vec.unitVector() * newDistanceBetweenZones); //zones should now be just separated
-				logGlobal->trace("New distance %f", targetZone->getCenter().dist2d(misplacedZone->getCenter()));
+				targetDistance = distance;
+				targetZone = j;
 			}
 		}
 	}
+	if (targetZone < 0) //TODO: consider refactoring duplicated code
+		return false;
+
+	const int j = targetZone;
+	const float dx = x[i] - x[j];
+	const float dy = y[i] - y[j];
+	const float length = std::sqrt(dx * dx + dy * dy);
+	if (length == 0) //no direction to move in
+		return false;
+
+	float newDistanceBetweenZones = 0;
+	if (totalDistance > totalOverlap)
+		newDistanceBetweenZones = std::max(size[i], size[j]) / mapSize; //zones should now overlap by half size
+	else
+		newDistanceBetweenZones = (size[i] + size[j]) / mapSize; //zones should now be just separated
+
+	logGlobal->trace("Moving zone %d from %s relative to %d at %s", i, getCenter(i).toString(), j, getCenter(j).toString());
+	x[i] = x[j] + dx / length * newDistanceBetweenZones;
+	y[i] = y[j] + dy / length * newDistanceBetweenZones;
+	logGlobal->trace("New distance %f", distanceBetween(i, j));
+	return true;
 }
 
 float CZonePlacer::metric (const int3 &A, const int3 &B) const
@@ -481,7 +576,7 @@ void CZonePlacer::assignZones(const CMapGenOptions * mapGenOptions)
 	auto moveZoneToCenterOfMass = [](std::shared_ptr<CRmgTemplateZone> zone) -> void
 	{
 		int3 total(0, 0, 0);
-		auto tiles = zone->getTileInfo();
+		auto & tiles = zone->getTileInfo();
 		for (auto tile : tiles)
 		{
 			total += tile;
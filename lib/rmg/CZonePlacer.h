@@ -22,8 +22,57 @@ class CMapGenerator;
 
 typedef std::vector<std::pair<TRmgTemplateZoneId, std::shared_ptr<CRmgTemplateZone>>> TZoneVector;
 typedef std::map <TRmgTemplateZoneId, std::shared_ptr<CRmgTemplateZone>> TZoneMap;
-typedef std::map <std::shared_ptr<CRmgTemplateZone>, float3> TForceVector;
-typedef std::map <std::shared_ptr<CRmgTemplateZone>, float> TDistanceVector;
+
+/// Zone centers and forces acting on them during placement, stored in flat arrays indexed by zone.
+/// Coordinates are relative to map size, (0,1) on both axes.
+class DLL_LINKAGE CZoneLayout
+{
+public:
+	/// mapSize is square root of map area in tiles, zone sizes are divided by it
+	CZoneLayout(float mapSize, float gravityConstant, float stiffnessConstant);
+
+	int addZone(const float3 & center, float size); //returns index of zone
+	void addConnection(int zone, int otherZone); //zone is attracted to otherZone
+	int getZoneCount() const;
+
+	float3 getCenter(int zone) const;
+	void setCenter(int zone, const float3 & center);
+
+	/// Single step of placement: attract connected zones, separate overlapping ones and move the most misplaced zone.
+	/// Returns summed distance that zones travelled in this step
+	float iterate();
+	/// Fitness after last iteration, lower is better
+	float getTotalDistance() const;
+	float getTotalOverlap() const;
+
+	//steps of iterate(), public for testing
+	void attractConnectedZones(); //sets forces and distances
+	void separateOverlappingZones(); //sets forces and overlaps
+	void applyForces();
+	bool moveOneZone(); //uses forces applied in this iteration, returns true if a zone was moved
+
+private:
+	float mapSize;
+	float gravityConstant;
+	float stiffnessConstant;
+
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<si32> level;
+	std::vector<float> size;
+
+	std::vector<std::vector<int>> connections;
+
+	std::vector<float> forceX;
+	std::vector<float> forceY;
+	std::vector<float> totalForceX; //both attraction and pushback in current iteration
+	std::vector<float> totalForceY;
+	std::vector<float> distances; //to connected zones that are too far
+	std::vector<float> overlaps; //with other zones and map boundaries
+
+	static float getDistance(float distance); //additional scaling without 0 divison
+	float distanceBetween(int zone, int otherZone) const;
+};
 
 class CZonePlacer
 {
@@ -31,13 +80,9 @@ public:
 	explicit CZonePlacer(CMapGenerator * gen);
 	int3 cords (const float3 f) const;
 	float metric (const int3 &a, const int3 &b) const;
-	float getDistance(float distance) const; //additional scaling without 0 divison
 	~CZonePlacer();
 
 	void prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const bool underground, CRandomGenerator * rand);
-	void attractConnectedZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &distances);
-	void separateOverlappingZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &overlaps);
-	void moveOneZone(TZoneMap &zones, TForceVector &totalForces, TDistanceVector &distances, TDistanceVector &overlaps);
 	void placeZones(const CMapGenOptions * mapGenOptions, CRandomGenerator * rand);
 	void assignZones(const CMapGenOptions * mapGenOptions);
 
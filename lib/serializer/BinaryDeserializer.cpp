@@ -12,11 +12,14 @@
 #include "../filesystem/FileStream.h"
 
 #include "../registerTypes/RegisterTypes.h"
+#include "../CThreadHelper.h"
 
 extern template void registerTypes<BinaryDeserializer>(BinaryDeserializer & s);
 
+const size_t CLoadFile::PREFETCH_CHUNK_SIZE;
+
 CLoadFile::CLoadFile(const boost::filesystem::path & fname, int minimalVersion)
-	: serializer(this)
+	: readPos(0), bytesAvailable(0), knownAvailable(0), prefetchFailed(false), prefetchAborted(false), serializer(this)
 {
 	registerTypes(serializer);
 	openNextFile(fname, minimalVersion);
@@ -24,14 +27,77 @@ CLoadFile::CLoadFile(const boost::filesystem::path & fname, int minimalVersion)
 
 CLoadFile::~CLoadFile()
 {
+	stopPrefetch();
 }
 
 int CLoadFile::read(void * data, unsigned size)
 {
-	sfile->read((char*)data,size);
+	if(!size)
+		return size;
+
+	if(readPos + size > buffer.size())
+		THROW_FORMAT("Error: unexpected end of file %s!", fName);
+
+	const size_t requiredBytes = readPos + size;
+	if(knownAvailable < requiredBytes)
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		while(bytesAvailable < requiredBytes && !prefetchFailed)
+			cond.wait(lock);
+
+		if(bytesAvailable < requiredBytes)
+			THROW_FORMAT("Error: failed to read %s!", fName);
+
+		knownAvailable = bytesAvailable;
+	}
+
+	std::copy_n(buffer.data() + readPos, size, static_cast<ui8 *>(data));
+	readPos += size;
 	return size;
 }
 
+void CLoadFile::prefetch()
+{
+	setThreadName("CLoadFile::prefetch");
+
+	size_t loaded = 0;
+	try
+	{
+		while(loaded < buffer.size())
+		{
+			const size_t chunk = std::min(PREFETCH_CHUNK_SIZE, buffer.size() - loaded);
+			sfile->read(reinterpret_cast<char *>(buffer.data() + loaded), chunk);
+			loaded += chunk;
+
+			boost::unique_lock<boost::mutex> lock(mx);
+			bytesAvailable = loaded;
+			cond.notify_all();
+			if(prefetchAborted)
+				return;
+		}
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to read %s: %s", fName, e.what());
+		boost::unique_lock<boost::mutex> lock(mx);
+		prefetchFailed = true;
+		cond.notify_all();
+	}
+}
+
+void CLoadFile::stopPrefetch()
+{
+	if(!prefetchThread)
+		return;
+
+	{
+		boost::unique_lock<boost::mutex> lock(mx);
+		prefetchAborted = true;
+	}
+	prefetchThread->join();
+	prefetchThread.reset();
+}
+
 void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalVersion)
 {
 	assert(!serializer.reverseEndianess);
@@ -39,6 +105,8 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalV
 
 	try
 	{
+		stopPrefetch();
+
 		fName = fname.string();
 		sfile = make_unique<FileStream>(fname, std::ios::in | std::ios::binary);
 		sfile->exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
@@ -46,10 +114,18 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalV
 		if(!(*sfile))
 			THROW_FORMAT("Error: cannot open to read %s!", fName);
 
+		buffer.resize(boost::filesystem::file_size(fname));
+		readPos = 0;
+		bytesAvailable = 0;
+		knownAvailable = 0;
+		prefetchFailed = false;
+		prefetchAborted = false;
+		prefetchThread = make_unique<boost::thread>(&CLoadFile::prefetch, this);
+
 		//we can read
-		char buffer[4];
-		sfile->read(buffer, 4);
-		if(std::memcmp(buffer,"VCMI",4))
+		char magic[4];
+		read(magic, 4);
+		if(std::memcmp(magic,"VCMI",4))
 			THROW_FORMAT("Error: not a VCMI file(%s)!", fName);
 
 		serializer & serializer.fileVersion;
@@ -83,14 +159,28 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, int minimalV
 void CLoadFile::reportState(vstd::CLoggerBase * out)
 {
 	out->debug("CLoadFile");
-	if(!!sfile && *sfile)
-		out->debug("\tOpened %s Position: %d", fName, sfile->tellg());
+	if(!!sfile)
+		out->debug("\tOpened %s Position: %d", fName, readPos);
+}
+
+size_t CLoadFile::getReadPosition() const
+{
+	return readPos;
+}
+
+bool CLoadFile::isEndOfFile() const
+{
+	return readPos >= buffer.size();
 }
 
 void CLoadFile::clear()
 {
+	stopPrefetch();
 	sfile = nullptr;
 	fName.clear();
+	buffer.clear();
+	readPos = 0;
+	knownAvailable = 0;
 	serializer.fileVersion = 0;
 }
 
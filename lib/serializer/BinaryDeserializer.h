@@ -238,7 +238,7 @@ public:
 		range::copy(convData, data.begin());
 	}
 
-	template <typename T, typename std::enable_if < !std::is_same<T, bool >::value, int  >::type = 0>
+	template <typename T, typename std::enable_if < !std::is_same<T, bool >::value && !std::is_fundamental<T>::value, int  >::type = 0>
 	void load(std::vector<T> &data)
 	{
 		ui32 length = readAndCheckLength();
@@ -247,6 +247,50 @@ public:
 			load( data[i]);
 	}
 
+	template <typename T, typename std::enable_if < !std::is_fundamental<T>::value, int  >::type = 0>
+	void loadElements(T * data, size_t count)
+	{
+		for(size_t i = 0; i < count; i++)
+			load(data[i]);
+	}
+
+	template <typename T, typename std::enable_if < std::is_fundamental<T>::value, int  >::type = 0>
+	void loadElements(T * data, size_t count)
+	{
+		if(!count)
+			return;
+
+		this->read(data, count * sizeof(T));
+		if(reverseEndianess && sizeof(T) > 1)
+		{
+			for(size_t i = 0; i < count; i++)
+			{
+				char * dataPtr = reinterpret_cast<char *>(data + i);
+				std::reverse(dataPtr, dataPtr + sizeof(T));
+			}
+		}
+	}
+
+	template <typename T, typename std::enable_if < !std::is_same<T, bool >::value && std::is_fundamental<T>::value, int  >::type = 0>
+	void load(std::vector<T> &data)
+	{
+		ui32 length = readAndCheckLength();
+		data.resize(length);
+		if(!length)
+			return;
+
+		// contiguous primitives - read whole buffer at once, then fix byte order of each element if needed
+		this->read(data.data(), length * sizeof(T));
+		if(reverseEndianess && sizeof(T) > 1)
+		{
+			for(T & element : data)
+			{
+				char * dataPtr = reinterpret_cast<char *>(&element);
+				std::reverse(dataPtr, dataPtr + sizeof(T));
+			}
+		}
+	}
+
 	template < typename T, typename std::enable_if < std::is_pointer<T>::value, int  >::type = 0 >
 	void load(T &data)
 	{
@@ -403,6 +447,15 @@ public:
 			load( data[i] );
 	}
 	template <typename T>
+	void load(boost::multi_array<T, 3> &data)
+	{
+		ui32 extents[3];
+		for(ui32 i = 0; i < 3; i++)
+			extents[i] = readAndCheckLength();
+		data.resize(boost::extents[extents[0]][extents[1]][extents[2]]);
+		loadElements(data.data(), data.num_elements());
+	}
+	template <typename T>
 	void load(std::set<T> &data)
 	{
 		ui32 length = readAndCheckLength();
@@ -512,8 +565,25 @@ public:
 	}
 };
 
+/// Loads file written by CSaveFile
+/// File contents are read ahead into memory by background thread so disk access overlaps with deserialization
 class DLL_LINKAGE CLoadFile : public IBinaryReader
 {
+	static const size_t PREFETCH_CHUNK_SIZE = 1 << 20;
+
+	std::vector<ui8> buffer; //whole file, filled by prefetch thread
+	size_t readPos; //index of the next byte to be read
+	size_t bytesAvailable; //amount of bytes already read from disk, guarded by mx
+	size_t knownAvailable; //last value of bytesAvailable seen by the reading thread, read without locking
+	bool prefetchFailed; //guarded by mx
+	bool prefetchAborted; //guarded by mx
+
+	boost::mutex mx;
+	boost::condition_variable cond;
+	std::unique_ptr<boost::thread> prefetchThread;
+
+	void prefetch();
+	void stopPrefetch();
 public:
 	BinaryDeserializer serializer;
 
@@ -528,6 +598,9 @@ public:
 	void clear();
 	void reportState(vstd::CLoggerBase * out) override;
 
+	size_t getReadPosition() const;
+	bool isEndOfFile() const;
+
 	void checkMagicBytes(const std::string & text);
 
 	template<class T>
@@ -250,7 +250,7 @@ public:
 		T *internalPtr = data.get();
 		save(internalPtr);
 	}
-	template <typename T, typename std::enable_if < !std::is_same<T, bool >::value, int  >::type = 0>
+	template <typename T, typename std::enable_if < !std::is_same<T, bool >::value && !std::is_fundamental<T>::value, int  >::type = 0>
 	void save(const std::vector<T> &data)
 	{
 		ui32 length = data.size();
@@ -258,6 +258,27 @@ public:
 		for(ui32 i=0;i<length;i++)
 			save(data[i]);
 	}
+	template <typename T, typename std::enable_if < !std::is_fundamental<T>::value, int  >::type = 0>
+	void saveElements(const T * data, size_t count)
+	{
+		for(size_t i = 0; i < count; i++)
+			save(data[i]);
+	}
+	template <typename T, typename std::enable_if < std::is_fundamental<T>::value, int  >::type = 0>
+	void saveElements(const T * data, size_t count)
+	{
+		if(count)
+			this->write(data, count * sizeof(T));
+	}
+	template <typename T, typename std::enable_if < !std::is_same<T, bool >::value && std::is_fundamental<T>::value, int  >::type = 0>
+	void save(const std::vector<T> &data)
+	{
+		// contiguous primitives - dump whole buffer at once, same layout as element-wise save
+		ui32 length = data.size();
+		*this & length;
+		if(length)
+			this->write(data.data(), length * sizeof(T));
+	}
 	template <typename T, size_t N>
 	void save(const std::array<T, N> &data)
 	{
@@ -265,6 +286,16 @@ public:
 			save(data[i]);
 	}
 	template <typename T>
+	void save(const boost::multi_array<T, 3> &data)
+	{
+		for(ui32 i = 0; i < 3; i++)
+		{
+			ui32 extent = data.shape()[i];
+			save(extent);
+		}
+		saveElements(data.data(), data.num_elements());
+	}
+	template <typename T>
 	void save(const std::set<T> &data)
 	{
 		std::set<T> &d = const_cast<std::set<T> &>(data);
@@ -0,0 +1,70 @@
+/*
+ * CPackJournal.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CPackJournal.h"
+
+#include "../IGameCallback.h"
+#include "../NetPacksBase.h"
+
+CPackJournalWriter::CPackJournalWriter(const boost::filesystem::path & fname, CPrivilegedInfoCallback & game)
+	: file(fname), packsWritten(0)
+{
+	file.putMagicBytes(PACK_JOURNAL_MAGIC);
+	game.saveCommonState(file);
+
+	//from now on behave like connection in gameplay mode
+	file.serializer.smartPointerSerialization = false;
+	file.sendStackInstanceByIds = true;
+	file.addStdVecItems(game.gameState());
+
+	logGlobal->info("Recording packs to %s", fname.string());
+}
+
+CPackJournalWriter::~CPackJournalWriter()
+{
+	logGlobal->info("Pack journal %s closed, %d packs recorded", file.fName.string(), packsWritten);
+}
+
+void CPackJournalWriter::writePack(const CPack * pack)
+{
+	boost::unique_lock<boost::mutex> lock(mx);
+	file.serializer & pack;
+	packsWritten++;
+}
+
+CPackJournalReader::CPackJournalReader(const boost::filesystem::path & fname, CPrivilegedInfoCallback & game)
+	: file(fname, SERIALIZATION_VERSION)
+{
+	file.checkMagicBytes(PACK_JOURNAL_MAGIC);
+	game.loadCommonState(file);
+
+	file.serializer.smartPointerSerialization = false;
+	file.sendStackInstanceByIds = true;
+	file.addStdVecItems(game.gameState());
+}
+
+CPack * CPackJournalReader::readPack()
+{
+	if(file.isEndOfFile())
+		return nullptr;
+
+	CPack * pack = nullptr;
+	try
+	{
+		file.serializer & pack;
+	}
+	catch(std::exception & e)
+	{
+		//server may have been terminated in the middle of writing
+		logGlobal->warn("Pack journal %s is truncated at %d: %s", file.fName, file.getReadPosition(), e.what());
+		vstd::clear_pointer(pack);
+	}
+	return pack;
+}
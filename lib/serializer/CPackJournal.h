@@ -0,0 +1,44 @@
+/*
+ * CPackJournal.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "BinarySerializer.h"
+#include "BinaryDeserializer.h"
+
+struct CPack;
+class CPrivilegedInfoCallback;
+
+const std::string PACK_JOURNAL_MAGIC = "VCMIPACKS";
+
+/// Records game state followed by every pack sent to clients
+/// Packs are stored same way as in network stream: type id from CTypeList and objects referenced by ids
+class DLL_LINKAGE CPackJournalWriter
+{
+	boost::mutex mx;
+	CSaveFile file;
+	ui32 packsWritten;
+public:
+	CPackJournalWriter(const boost::filesystem::path & fname, CPrivilegedInfoCallback & game); //throws!
+	~CPackJournalWriter();
+
+	void writePack(const CPack * pack);
+};
+
+/// Reads journal written by CPackJournalWriter
+class DLL_LINKAGE CPackJournalReader
+{
+	CLoadFile file;
+public:
+	/// loads handlers and initial game state into game callback
+	CPackJournalReader(const boost::filesystem::path & fname, CPrivilegedInfoCallback & game); //throws!
+
+	/// returns next pack or nullptr if there are no more packs; caller owns returned pack
+	CPack * readPack();
+};
@@ -10,6 +10,8 @@
 #include "StdInc.h"
 #include "CTypeList.h"
 
+#include <boost/core/demangle.hpp>
+
 #include "../registerTypes/RegisterTypes.h"
 
 extern template void registerTypes<CTypeList>(CTypeList & s);
@@ -45,6 +47,12 @@ ui16 CTypeList::getTypeID(const std::type_info *type, bool throws) const
 	return descriptor->typeID;
 }
 
+std::string CTypeList::getTypeName(const std::type_info *type) const
+{
+	auto descriptor = getTypeDescriptor(type, false);
+	return boost::core::demangle(descriptor ? descriptor->name : type->name());
+}
+
 std::vector<CTypeList::TypeInfoPtr> CTypeList::castSequence(TypeInfoPtr from, TypeInfoPtr to) const
 {
 	if(!strcmp(from->name, to->name))
@@ -147,6 +147,15 @@ public:
 		return getTypeID(getTypeInfo(t), throws);
 	}
 
+	/// Demangled name of the registered type, for logs and reports
+	std::string getTypeName(const std::type_info *type) const;
+
+	template <typename T>
+	std::string getTypeName(const T * t = nullptr) const
+	{
+		return getTypeName(getTypeInfo(t));
+	}
+
 	template<typename TInput>
 	void * castToMostDerived(const TInput * inputPtr) const
 	{
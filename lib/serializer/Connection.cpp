@@ -32,6 +32,7 @@ using namespace boost::asio::ip;
 
 void CConnection::init()
 {
+	bytesWritten = 0;
 	socket->set_option(boost::asio::ip::tcp::no_delay(true));
 	socket->set_option(boost::asio::socket_base::send_buffer_size(4194304));
 	socket->set_option(boost::asio::socket_base::receive_buffer_size(4194304));
@@ -135,6 +136,7 @@ int CConnection::write(const void * data, unsigned size)
 	{
 		int ret;
 		ret = asio::write(*socket,asio::const_buffers_1(asio::const_buffer(data,size)));
+		bytesWritten += ret;
 		return ret;
 	}
 	catch(...)
@@ -204,6 +206,7 @@ CPack * CConnection::retrievePack()
 	CPack * pack = nullptr;
 	boost::unique_lock<boost::mutex> lock(*mutexRead);
 	iser & pack;
+	const auto receivedTime = std::chrono::steady_clock::now();
 	logNetwork->trace("Received CPack of type %s", (pack ? typeid(*pack).name() : "nullptr"));
 	if(pack == nullptr)
 	{
@@ -212,15 +215,18 @@ CPack * CConnection::retrievePack()
 	else
 	{
 		pack->c = this->shared_from_this();
+		pack->receivedTime = receivedTime;
 	}
 	return pack;
 }
 
-void CConnection::sendPack(const CPack * pack)
+size_t CConnection::sendPack(const CPack * pack)
 {
 	boost::unique_lock<boost::mutex> lock(*mutexWrite);
 	logNetwork->trace("Sending a pack of type %s", typeid(*pack).name());
+	const ui64 before = bytesWritten;
 	oser & pack;
+	return bytesWritten - before;
 }
 
 void CConnection::disableStackSendingByID()
@@ -56,6 +56,7 @@ class DLL_LINKAGE CConnection
 	int read(void * data, unsigned size) override;
 
 	std::shared_ptr<boost::asio::io_service> io_service; //can be empty if connection made from socket
+	ui64 bytesWritten; //guarded by mutexWrite
 public:
 	BinaryDeserializer iser;
 	BinarySerializer oser;
@@ -83,7 +84,7 @@ public:
 	virtual ~CConnection();
 
 	CPack * retrievePack();
-	void sendPack(const CPack * pack);
+	size_t sendPack(const CPack * pack); //returns number of bytes written
 
 	void disableStackSendingByID();
 	void enableStackSendingByID();
@@ -0,0 +1,299 @@
+/*
+ * CRmgBatch.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CRmgBatch.h"
+
+#include "../lib/CThreadHelper.h"
+#include "../lib/mapObjects/CObjectHandler.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapping/CMapService.h"
+#include "../lib/rmg/CMapGenerator.h"
+#include "../lib/rmg/CRmgTemplate.h"
+
+CRmgBatch::MapResult::MapResult()
+	: seed(0), success(false), totalTime(0), objects(0), towns(0), mines(0), monsters(0), reachableTowns(0)
+{
+}
+
+JsonNode CRmgBatch::MapResult::toJson() const
+{
+	JsonNode ret;
+	ret["seed"].Integer() = seed;
+	ret["success"].Bool() = success;
+	if(!success)
+		ret["error"].String() = error;
+	ret["template"].String() = templateName;
+	ret["file"].String() = fileName;
+	ret["totalTime"].Integer() = totalTime;
+	for(auto & phase : phaseTimes)
+		ret["phaseTimes"][phase.first].Integer() = phase.second;
+	ret["objects"].Integer() = objects;
+	ret["towns"].Integer() = towns;
+	ret["mines"].Integer() = mines;
+	ret["monsters"].Integer() = monsters;
+	ret["reachableTowns"].Integer() = reachableTowns;
+	return ret;
+}
+
+CRmgBatch::CRmgBatch(const CMapGenOptions & options, const boost::filesystem::path & outputDir)
+	: options(options), outputDir(outputDir), threadCount(0), dryRun(false)
+{
+}
+
+void CRmgBatch::setThreadCount(int threads)
+{
+	threadCount = threads;
+}
+
+void CRmgBatch::setDryRun(bool value)
+{
+	dryRun = value;
+}
+
+void CRmgBatch::run(int firstSeed, int count)
+{
+	if(!dryRun)
+		boost::filesystem::create_directories(outputDir);
+
+	results.clear();
+	results.resize(count);
+
+	//every task has its own generator and options, results are written to separate slots
+	std::vector<Task> tasks;
+	for(int i = 0; i < count; i++)
+	{
+		tasks.push_back([this, i, firstSeed]()
+		{
+			results[i] = generateMap(firstSeed + i);
+		});
+	}
+
+	int threads = threadCount > 0 ? threadCount : boost::thread::hardware_concurrency();
+	CThreadHelper helper(&tasks, std::max(1, std::min<int>(threads, tasks.size())));
+	helper.run();
+}
+
+CRmgBatch::MapResult CRmgBatch::generateMap(int seed) const
+{
+	MapResult result;
+	result.seed = seed;
+
+	auto start = std::chrono::steady_clock::now();
+	try
+	{
+		CMapGenOptions mapOptions(options);
+		CMapGenerator generator;
+		generator.setThreadCount(1); //maps are already generated in parallel
+
+		std::unique_ptr<CMap> map = generator.generate(&mapOptions, seed);
+
+		result.templateName = mapOptions.getMapTemplate()->getName();
+		result.phaseTimes = generator.getPhaseTimes();
+		collectStats(map.get(), result);
+
+		if(!dryRun)
+		{
+			result.fileName = boost::str(boost::format("%s_%d.vmap") % result.templateName % seed);
+			CMapService mapService;
+			mapService.saveMap(map, outputDir / result.fileName);
+		}
+		result.success = true;
+	}
+	catch(std::exception & e)
+	{
+		result.error = e.what();
+		logGlobal->error("Generation of map with seed %d failed: %s", seed, result.error);
+	}
+	result.totalTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	logGlobal->info("Map with seed %d done in %d ms", seed, static_cast<int>(result.totalTime));
+	return result;
+}
+
+void CRmgBatch::collectStats(const CMap * map, MapResult & result)
+{
+	for(auto & object : map->objects)
+	{
+		if(!object)
+			continue;
+
+		result.objects++;
+		switch(object->ID)
+		{
+		case Obj::TOWN:
+		case Obj::RANDOM_TOWN:
+			result.towns++;
+			break;
+		case Obj::MINE:
+		case Obj::ABANDONED_MINE:
+			result.mines++;
+			break;
+		case Obj::MONSTER:
+		case Obj::RANDOM_MONSTER:
+		case Obj::RANDOM_MONSTER_L1:
+		case Obj::RANDOM_MONSTER_L2:
+		case Obj::RANDOM_MONSTER_L3:
+		case Obj::RANDOM_MONSTER_L4:
+		case Obj::RANDOM_MONSTER_L5:
+		case Obj::RANDOM_MONSTER_L6:
+		case Obj::RANDOM_MONSTER_L7:
+			result.monsters++;
+			break;
+		}
+	}
+	result.reachableTowns = countReachableTowns(map);
+}
+
+ui32 CRmgBatch::countReachableTowns(const CMap * map)
+{
+	//teleports lead to all objects of the same channel: monolith type and subID, all gates are treated as one channel
+	typedef std::pair<si32, si32> TChannel;
+	std::map<TChannel, std::vector<int3>> exits;
+	std::vector<int3> towns;
+
+	auto getChannel = [](const CGObjectInstance * object, bool entrance) -> TChannel
+	{
+		switch(object->ID)
+		{
+		case Obj::MONOLITH_ONE_WAY_ENTRANCE:
+			return entrance ? TChannel(Obj::MONOLITH_ONE_WAY_EXIT, object->subID) : TChannel(-1, -1);
+		case Obj::MONOLITH_ONE_WAY_EXIT:
+			return entrance ? TChannel(-1, -1) : TChannel(Obj::MONOLITH_ONE_WAY_EXIT, object->subID);
+		case Obj::MONOLITH_TWO_WAY:
+			return TChannel(Obj::MONOLITH_TWO_WAY, object->subID);
+		case Obj::SUBTERRANEAN_GATE:
+			return TChannel(Obj::SUBTERRANEAN_GATE, 0);
+		default:
+			return TChannel(-1, -1);
+		}
+	};
+
+	for(auto & object : map->objects)
+	{
+		if(!object)
+			continue;
+
+		if(object->ID == Obj::TOWN || object->ID == Obj::RANDOM_TOWN)
+			towns.push_back(object->visitablePos());
+
+		auto channel = getChannel(object, false);
+		if(channel.first >= 0)
+			exits[channel].push_back(object->visitablePos());
+	}
+
+	if(towns.empty())
+		return 0;
+
+	boost::multi_array<bool, 3> visited(boost::extents[map->width][map->height][map->twoLevel ? 2 : 1]);
+	std::queue<int3> queue;
+
+	auto visit = [&](const int3 & tile)
+	{
+		if(!visited[tile.x][tile.y][tile.z])
+		{
+			visited[tile.x][tile.y][tile.z] = true;
+			queue.push(tile);
+		}
+	};
+
+	visit(towns.front());
+	while(!queue.empty())
+	{
+		int3 tile = queue.front();
+		queue.pop();
+
+		const TerrainTile & terrain = map->getTile(tile);
+		bool isTeleport = false;
+		for(auto object : terrain.visitableObjects)
+		{
+			if(getChannel(object, false).first >= 0)
+				isTeleport = true;
+
+			auto channel = getChannel(object, true);
+			if(channel.first >= 0)
+			{
+				isTeleport = true;
+				for(auto & exit : exits[channel])
+					visit(exit);
+			}
+		}
+
+		//hero can't walk through town or other blocking object, but leaves teleport or starting town on foot
+		if(terrain.blocked && !isTeleport && tile != towns.front())
+			continue;
+
+		for(const int3 & dir : int3::getDirs())
+		{
+			int3 next = tile + dir;
+			if(!map->isInTheMap(next))
+				continue;
+
+			const TerrainTile & nextTerrain = map->getTile(next);
+			if(nextTerrain.entrableTerrain(true, false) && (!nextTerrain.blocked || nextTerrain.visitable))
+				visit(next);
+		}
+	}
+
+	ui32 reachable = 0;
+	for(auto & town : towns)
+	{
+		if(visited[town.x][town.y][town.z])
+			reachable++;
+	}
+	return reachable;
+}
+
+const std::vector<CRmgBatch::MapResult> & CRmgBatch::getResults() const
+{
+	return results;
+}
+
+void CRmgBatch::printReport(std::ostream & out) const
+{
+	out << boost::format("%10s %-24s %8s %8s %6s %6s %8s %10s %s\n")
+		% "Seed" % "Template" % "Time,ms" % "Objects" % "Towns" % "Mines" % "Monsters" % "Reachable" % "Status";
+
+	si64 totalTime = 0;
+	int failed = 0;
+	int disconnected = 0;
+	for(auto & result : results)
+	{
+		totalTime += result.totalTime;
+		if(!result.success)
+			failed++;
+		else if(result.reachableTowns < result.towns)
+			disconnected++;
+
+		out << boost::format("%10d %-24s %8d %8d %6d %6d %8d %10d %s\n")
+			% result.seed
+			% result.templateName
+			% result.totalTime
+			% result.objects
+			% result.towns
+			% result.mines
+			% result.monsters
+			% result.reachableTowns
+			% (result.success ? result.fileName : result.error);
+	}
+
+	if(!results.empty())
+	{
+		out << boost::format("\nMaps: %d, failed: %d, with unreachable towns: %d, mean time: %d ms\n")
+			% results.size() % failed % disconnected % (totalTime / (si64)results.size());
+	}
+}
+
+JsonNode CRmgBatch::toJson() const
+{
+	JsonNode ret;
+	for(auto & result : results)
+		ret["maps"].Vector().push_back(result.toJson());
+	return ret;
+}
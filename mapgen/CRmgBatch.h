@@ -0,0 +1,66 @@
+/*
+ * CRmgBatch.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "../lib/JsonNode.h"
+#include "../lib/rmg/CMapGenOptions.h"
+
+class CMap;
+
+/// Generates series of random maps with consecutive seeds on several threads
+class CRmgBatch
+{
+public:
+	struct MapResult
+	{
+		int seed;
+		bool success;
+		std::string error;
+		std::string templateName;
+		std::string fileName; //empty if map was not saved
+		si64 totalTime; //milliseconds, including saving
+		std::vector<std::pair<std::string, si64>> phaseTimes;
+
+		ui32 objects;
+		ui32 towns;
+		ui32 mines;
+		ui32 monsters;
+		ui32 reachableTowns; //from first town, by land and teleports
+
+		MapResult();
+		JsonNode toJson() const;
+	};
+
+	/// options are copied for every map, as generator modifies them
+	CRmgBatch(const CMapGenOptions & options, const boost::filesystem::path & outputDir);
+
+	/// Number of maps generated at the same time, 0 - one per core
+	void setThreadCount(int threads);
+	/// Do not write maps, only generate and validate them
+	void setDryRun(bool value);
+
+	void run(int firstSeed, int count);
+
+	const std::vector<MapResult> & getResults() const;
+	void printReport(std::ostream & out) const;
+	JsonNode toJson() const;
+
+private:
+	CMapGenOptions options;
+	boost::filesystem::path outputDir;
+	int threadCount;
+	bool dryRun;
+	std::vector<MapResult> results;
+
+	MapResult generateMap(int seed) const;
+
+	static void collectStats(const CMap * map, MapResult & result);
+	static ui32 countReachableTowns(const CMap * map);
+};
@@ -0,0 +1,210 @@
+/*
+ * vcmirmg.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include <boost/program_options.hpp>
+
+#include "CRmgBatch.h"
+
+#include "../lib/CConfigHandler.h"
+#include "../lib/CConsoleHandler.h"
+#include "../lib/GameConstants.h"
+#include "../lib/VCMIDirs.h"
+#include "../lib/VCMI_Lib.h"
+#include "../lib/filesystem/FileStream.h"
+#include "../lib/logging/CBasicLogConfigurator.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/rmg/CRmgTemplate.h"
+
+static void handleCommandOptions(int argc, char * argv[], boost::program_options::variables_map & options)
+{
+	namespace po = boost::program_options;
+	po::options_description opts("Allowed options");
+	opts.add_options()
+	("help,h", "display help and exit")
+	("version,v", "display version information and exit")
+	("list-templates", "list available templates and exit")
+	("template,t", po::value<std::string>(), "template name, random template fitting other settings if not set")
+	("size,s", po::value<std::string>()->default_value("m"), "map size: s, m, l or xl")
+	("one-level", "generate map without underground")
+	("players,p", po::value<int>()->default_value(4), "number of players")
+	("humans", po::value<int>()->default_value(1), "number of human players, others are computer")
+	("comp-only", po::value<int>(), "number of computer only players, random if not set")
+	("water", po::value<std::string>()->default_value("random"), "water content: none, normal, islands or random")
+	("monsters", po::value<std::string>()->default_value("random"), "monster strength: weak, normal, strong or random")
+	("seed", po::value<int>()->default_value(1), "seed of first map, next maps use following seeds")
+	("count,n", po::value<int>()->default_value(1), "number of maps to generate")
+	("threads,j", po::value<int>()->default_value(0), "number of maps generated at once, 0 - one per core")
+	("output,o", po::value<std::string>(), "directory for generated maps, RandomMaps in cache directory if not set")
+	("dry-run", "do not save maps, only generate and validate them")
+	("stats", po::value<std::string>(), "save per map statistics to given JSON file");
+
+	try
+	{
+		po::store(po::parse_command_line(argc, argv, opts), options);
+	}
+	catch(std::exception & e)
+	{
+		std::cerr << "Failure during parsing command-line options:\n" << e.what() << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	po::notify(options);
+	if(options.count("version"))
+	{
+		printf("%s\n", GameConstants::VCMI_VERSION.c_str());
+		exit(0);
+	}
+
+	if(options.count("help"))
+	{
+		printf("%s - generates random maps in batch\n", GameConstants::VCMI_VERSION.c_str());
+		printf("Usage: vcmirmg [options]\n\n");
+		std::cout << opts;
+		exit(0);
+	}
+}
+
+template<typename T>
+static T findOption(const std::string & what, const std::string & value, const std::map<std::string, T> & values)
+{
+	auto it = values.find(value);
+	if(it == values.end())
+		throw std::runtime_error(boost::str(boost::format("Unknown %s: %s") % what % value));
+	return it->second;
+}
+
+static CMapGenOptions createOptions(const boost::program_options::variables_map & opts)
+{
+	static const std::map<std::string, int> sizes =
+	{
+		{"s", CMapHeader::MAP_SIZE_SMALL},
+		{"m", CMapHeader::MAP_SIZE_MIDDLE},
+		{"l", CMapHeader::MAP_SIZE_LARGE},
+		{"xl", CMapHeader::MAP_SIZE_XLARGE}
+	};
+	static const std::map<std::string, EWaterContent::EWaterContent> waterContents =
+	{
+		{"none", EWaterContent::NONE},
+		{"normal", EWaterContent::NORMAL},
+		{"islands", EWaterContent::ISLANDS},
+		{"random", EWaterContent::RANDOM}
+	};
+	static const std::map<std::string, EMonsterStrength::EMonsterStrength> monsterStrengths =
+	{
+		{"weak", EMonsterStrength::GLOBAL_WEAK},
+		{"normal", EMonsterStrength::GLOBAL_NORMAL},
+		{"strong", EMonsterStrength::GLOBAL_STRONG},
+		{"random", EMonsterStrength::RANDOM}
+	};
+
+	CMapGenOptions options;
+
+	const int size = findOption("map size", opts["size"].as<std::string>(), sizes);
+	options.setWidth(size);
+	options.setHeight(size);
+	options.setHasTwoLevels(!opts.count("one-level"));
+
+	const int players = opts["players"].as<int>();
+	const int humans = opts["humans"].as<int>();
+	if(players < 1 || players > PlayerColor::PLAYER_LIMIT_I)
+		throw std::runtime_error(boost::str(boost::format("Player count must be between 1 and %d") % PlayerColor::PLAYER_LIMIT_I));
+	if(humans < 1 || humans > players)
+		throw std::runtime_error("There must be at least one human player");
+
+	options.setPlayerCount(players);
+	if(opts.count("comp-only"))
+	{
+		const int compOnly = opts["comp-only"].as<int>();
+		if(compOnly < 0 || compOnly > players - humans)
+			throw std::runtime_error("Too many computer only players");
+		options.setCompOnlyPlayerCount(compOnly);
+	}
+	for(int color = humans; color < options.getHumanOnlyPlayerCount(); color++)
+		options.setPlayerTypeForStandardPlayer(PlayerColor(color), EPlayerType::AI);
+
+	options.setWaterContent(findOption("water content", opts["water"].as<std::string>(), waterContents));
+	options.setMonsterStrength(findOption("monster strength", opts["monsters"].as<std::string>(), monsterStrengths));
+
+	if(opts.count("template"))
+	{
+		const std::string name = opts["template"].as<std::string>();
+		for(auto & entry : options.getAvailableTemplates())
+		{
+			if(entry.second->getName() == name)
+				options.setMapTemplate(entry.second);
+		}
+		if(!options.getMapTemplate())
+			throw std::runtime_error("Unknown template: " + name);
+	}
+
+	if(!options.checkOptions())
+		throw std::runtime_error("No template fits given settings");
+
+	return options;
+}
+
+int main(int argc, char * argv[])
+{
+	boost::program_options::variables_map opts;
+	handleCommandOptions(argc, argv, opts);
+
+	console = new CConsoleHandler();
+	CBasicLogConfigurator logConfig(VCMIDirs::get().userCachePath() / "VCMI_RMG_log.txt", console);
+	logConfig.configureDefault();
+
+	preinitDLL(console);
+	settings.init();
+	logConfig.configure();
+	loadDLLClasses();
+
+	int result = EXIT_SUCCESS;
+	try
+	{
+		if(opts.count("list-templates"))
+		{
+			CMapGenOptions options;
+			for(auto & entry : options.getAvailableTemplates())
+				std::cout << entry.second->getName() << std::endl;
+		}
+		else
+		{
+			boost::filesystem::path outputDir = VCMIDirs::get().userCachePath() / "RandomMaps";
+			if(opts.count("output"))
+				outputDir = opts["output"].as<std::string>();
+
+			CRmgBatch batch(createOptions(opts), outputDir);
+			batch.setThreadCount(opts["threads"].as<int>());
+			batch.setDryRun(opts.count("dry-run"));
+			batch.run(opts["seed"].as<int>(), opts["count"].as<int>());
+			batch.printReport(std::cout);
+
+			if(opts.count("stats"))
+			{
+				FileStream file(opts["stats"].as<std::string>(), std::ofstream::out | std::ofstream::trunc);
+				file << batch.toJson().toJson();
+			}
+
+			for(auto & mapResult : batch.getResults())
+			{
+				if(!mapResult.success)
+					result = EXIT_FAILURE;
+			}
+		}
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Map generation failed: %s", e.what());
+		result = EXIT_FAILURE;
+	}
+
+	vstd::clear_pointer(VLC);
+	return result;
+}
@@ -0,0 +1,108 @@
+/*
+ * CReplayGame.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "CReplayGame.h"
+
+#include "../lib/CGameState.h"
+#include "../lib/NetPacks.h"
+#include "../lib/mapObjects/CObjectHandler.h"
+#include "../lib/serializer/CPackJournal.h"
+#include "../lib/serializer/CTypeList.h"
+
+CReplayGame::PackTypeStats::PackTypeStats()
+	: count(0), totalTime(0), longestTime(0)
+{
+}
+
+CReplayGame::CReplayGame()
+	: packsApplied(0), applyTime(0), wallTime(0)
+{
+	IObjectInterface::cb = this;
+}
+
+CReplayGame::~CReplayGame()
+{
+	journal.reset();
+	vstd::clear_pointer(gs);
+	IObjectInterface::cb = nullptr;
+}
+
+void CReplayGame::load(const boost::filesystem::path & fname)
+{
+	logGlobal->info("Loading pack journal %s", fname.string());
+	journal = make_unique<CPackJournalReader>(fname, *this);
+	logGlobal->info("Initial game state loaded, day %d", gs->day);
+}
+
+void CReplayGame::run()
+{
+	assert(journal);
+	auto start = std::chrono::steady_clock::now();
+
+	while(CPack * pack = journal->readPack())
+	{
+		const ui16 typeID = typeList.getTypeID(pack);
+		PackTypeStats & typeStats = stats[typeID];
+		if(typeStats.name.empty())
+			typeStats.name = typeList.getTypeName(pack);
+
+		auto applyStart = std::chrono::steady_clock::now();
+		gs->apply(pack);
+		auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - applyStart);
+
+		typeStats.count++;
+		typeStats.totalTime += duration;
+		vstd::amax(typeStats.longestTime, duration);
+		applyTime += duration;
+		packsApplied++;
+
+		delete pack;
+	}
+
+	wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+	logGlobal->info("Replay finished, day %d", gs->day);
+}
+
+void CReplayGame::printReport(std::ostream & out) const
+{
+	using namespace std::chrono;
+	auto toMs = [](nanoseconds time)
+	{
+		return duration_cast<duration<double, std::milli>>(time).count();
+	};
+
+	const double wallSeconds = duration_cast<duration<double>>(wallTime).count();
+
+	out << boost::format("Packs applied: %d\n") % packsApplied;
+	out << boost::format("Wall time: %.1f ms, apply time: %.1f ms\n") % toMs(wallTime) % toMs(applyTime);
+	if(wallSeconds > 0)
+		out << boost::format("Throughput: %.0f packs/s\n") % (packsApplied / wallSeconds);
+
+	std::vector<const PackTypeStats *> sorted;
+	for(auto & entry : stats)
+		sorted.push_back(&entry.second);
+
+	boost::sort(sorted, [](const PackTypeStats * a, const PackTypeStats * b)
+	{
+		return a->totalTime > b->totalTime;
+	});
+
+	out << boost::format("\n%-40s %10s %12s %12s %12s\n") % "Pack type" % "Count" % "Total ms" % "Mean us" % "Max us";
+	for(auto typeStats : sorted)
+	{
+		const double meanUs = toMs(typeStats->totalTime) * 1000 / typeStats->count;
+		out << boost::format("%-40s %10d %12.2f %12.1f %12.1f\n")
+			% typeStats->name
+			% typeStats->count
+			% toMs(typeStats->totalTime)
+			% meanUs
+			% (toMs(typeStats->longestTime) * 1000);
+	}
+}
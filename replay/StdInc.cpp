@@ -0,0 +1,2 @@
+// Creates the precompiled header
+#include "StdInc.h"
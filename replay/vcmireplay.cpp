@@ -0,0 +1,90 @@
+/*
+ * vcmireplay.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include <boost/program_options.hpp>
+
+#include "CReplayGame.h"
+
+#include "../lib/CConfigHandler.h"
+#include "../lib/CConsoleHandler.h"
+#include "../lib/GameConstants.h"
+#include "../lib/VCMIDirs.h"
+#include "../lib/VCMI_Lib.h"
+#include "../lib/logging/CBasicLogConfigurator.h"
+
+static void handleCommandOptions(int argc, char * argv[], boost::program_options::variables_map & options)
+{
+	namespace po = boost::program_options;
+	po::options_description opts("Allowed options");
+	opts.add_options()
+	("help,h", "display help and exit")
+	("version,v", "display version information and exit")
+	("journal", po::value<std::string>(), "pack journal recorded by server with --record-packs");
+
+	po::positional_options_description positional;
+	positional.add("journal", 1);
+
+	try
+	{
+		po::store(po::command_line_parser(argc, argv).options(opts).positional(positional).run(), options);
+	}
+	catch(std::exception & e)
+	{
+		std::cerr << "Failure during parsing command-line options:\n" << e.what() << std::endl;
+	}
+
+	po::notify(options);
+	if(options.count("version"))
+	{
+		printf("%s\n", GameConstants::VCMI_VERSION.c_str());
+		exit(0);
+	}
+
+	if(options.count("help") || !options.count("journal"))
+	{
+		printf("%s - replays game recorded by VCMI server\n", GameConstants::VCMI_VERSION.c_str());
+		printf("Usage: vcmireplay [options] <journal>\n\n");
+		std::cout << opts;
+		exit(0);
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	boost::program_options::variables_map opts;
+	handleCommandOptions(argc, argv, opts);
+
+	console = new CConsoleHandler();
+	CBasicLogConfigurator logConfig(VCMIDirs::get().userCachePath() / "VCMI_Replay_log.txt", console);
+	logConfig.configureDefault();
+
+	preinitDLL(console);
+	settings.init();
+	logConfig.configure();
+	loadDLLClasses();
+
+	int result = EXIT_SUCCESS;
+	try
+	{
+		CReplayGame game;
+		game.load(opts["journal"].as<std::string>());
+		game.run();
+		game.printReport(std::cout);
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Replay failed: %s", e.what());
+		result = EXIT_FAILURE;
+	}
+
+	vstd::clear_pointer(VLC);
+	return result;
+}
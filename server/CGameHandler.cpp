@@ -46,6 +46,7 @@
 #include "../lib/registerTypes/RegisterTypes.h"
 #include "../lib/serializer/CTypeList.h"
 #include "../lib/serializer/Connection.h"
+#include "../lib/serializer/CPackJournal.h"
 #include "../lib/serializer/Cast.h"
 
 #ifndef _MSC_VER
@@ -1212,6 +1213,8 @@ void CGameHandler::handleClientDisconnection(std::shared_ptr<CConnection> c)
 
 void CGameHandler::handleReceivedPack(CPackForServer * pack)
 {
+	ui64 applyTime = 0;
+
 	//prepare struct informing that action was applied
 	auto sendPackageResponse = [&](bool succesfullyApplied)
 	{
@@ -1230,7 +1233,9 @@ void CGameHandler::handleReceivedPack(CPackForServer * pack)
 	}
 	else if(apply)
 	{
+		const auto applyStart = CPackMetrics::TClock::now();
 		const bool result = apply->applyOnGH(this, pack);
+		applyTime = CPackMetrics::microsecondsSince(applyStart);
 		if(result)
 			logGlobal->trace("Message %s successfully applied!", typeid(*pack).name());
 		else
@@ -1245,6 +1250,7 @@ void CGameHandler::handleReceivedPack(CPackForServer * pack)
 		sendPackageResponse(false);
 	}
 
+	packMetrics.addReceived(pack, CPackMetrics::microsecondsSince(pack->receivedTime), applyTime);
 	vstd::clear_pointer(pack);
 }
 
@@ -1527,6 +1533,15 @@ CGameHandler::CGameHandler(CVCMIServer * lobby)
 
 CGameHandler::~CGameHandler()
 {
+	packJournal.reset();
+	try
+	{
+		packMetrics.saveJson(VCMIDirs::get().userCachePath() / "VCMI_Server_metrics.json");
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to save pack metrics: %s", e.what());
+	}
 	delete spellEnv;
 	delete gs;
 }
@@ -1830,10 +1845,10 @@ void CGameHandler::newTurn()
 				fw.player = player;
 				// find all hidden tiles
 				const auto & fow = getPlayerTeam(player)->fogOfWarMap;
-				for (size_t i=0; i<fow.size(); i++)
-					for (size_t j=0; j<fow.at(i).size(); j++)
-						for (size_t k=0; k<fow.at(i).at(j).size(); k++)
-							if (!fow.at(i).at(j).at(k))
+				for (size_t i=0; i<fow.shape()[0]; i++)
+					for (size_t j=0; j<fow.shape()[1]; j++)
+						for (size_t k=0; k<fow.shape()[2]; k++)
+							if (!fow[i][j][k])
 								fw.tiles.insert(int3(i,j,k));
 
 				sendAndApply (&fw);
@@ -1857,6 +1872,8 @@ void CGameHandler::newTurn()
 		pickAllowedArtsSet(saa.arts, getRandomGenerator());
 		sendAndApply(&saa);
 	}
+	//clients compare it with their own state when applying the pack
+	n.stateHash = gs->calculateStateHash();
 	sendAndApply(&n);
 
 	if (newWeek)
@@ -2700,25 +2717,34 @@ void CGameHandler::heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2)
 void CGameHandler::sendToAllClients(CPackForClient * pack)
 {
 	logNetwork->trace("\tSending to all clients: %s", typeid(*pack).name());
+	size_t bytes = 0;
 	for (auto c : lobby->connections)
 	{
 		if(!c->isOpen())
 			continue;
 
-		c->sendPack(pack);
+		bytes += c->sendPack(pack);
 	}
+	packMetrics.addSent(pack, bytes);
+
+	if(packJournal)
+		packJournal->writePack(pack);
 }
 
 void CGameHandler::sendAndApply(CPackForClient * pack)
 {
 	sendToAllClients(pack);
+	const auto applyStart = CPackMetrics::TClock::now();
 	gs->apply(pack);
+	packMetrics.addApplied(pack, CPackMetrics::microsecondsSince(applyStart));
 	logNetwork->trace("\tApplied on gs: %s", typeid(*pack).name());
 }
 
 void CGameHandler::applyAndSend(CPackForClient * pack)
 {
+	const auto applyStart = CPackMetrics::TClock::now();
 	gs->apply(pack);
+	packMetrics.addApplied(pack, CPackMetrics::microsecondsSince(applyStart));
 	sendToAllClients(pack);
 }
 
@@ -2791,6 +2817,18 @@ void CGameHandler::load(const std::string & filename)
 	gs->updateOnLoad(lobby->si.get());
 }
 
+void CGameHandler::startRecordingPacks(const boost::filesystem::path & fname)
+{
+	try
+	{
+		packJournal = make_unique<CPackJournalWriter>(fname, *this);
+	}
+	catch(std::exception & e)
+	{
+		logGlobal->error("Failed to start recording packs to %s: %s", fname.string(), e.what());
+	}
+}
+
 bool CGameHandler::arrangeStacks(ObjectInstanceID id1, ObjectInstanceID id2, ui8 what, SlotID p1, SlotID p2, si32 val, PlayerColor player)
 {
 	const CArmedInstance * s1 = static_cast<const CArmedInstance *>(getObjInstance(id1)),
@@ -6453,7 +6491,7 @@ void CGameHandler::handleCheatCode(std::string & cheat, PlayerColor player, cons
 		for (int i = 0; i < gs->map->width; i++)
 			for (int j = 0; j < gs->map->height; j++)
 				for (int k = 0; k < (gs->map->twoLevel ? 2 : 1); k++)
-					if (!fowMap.at(i).at(j).at(k) || !fc.mode)
+					if (!fowMap[i][j][k] || !fc.mode)
 						hlp_tab[lastUnc++] = int3(i, j, k);
 		fc.tiles.insert(hlp_tab, hlp_tab + lastUnc);
 		delete [] hlp_tab;
@@ -12,6 +12,7 @@
 #include "../lib/FunctionList.h"
 #include "../lib/IGameCallback.h"
 #include "../lib/battle/BattleAction.h"
+#include "../lib/CPackMetrics.h"
 #include "CQuery.h"
 
 class CGameHandler;
@@ -32,6 +33,7 @@ class SpellCastEnvironment;
 
 template<typename T> class CApplier;
 class CBaseForGHApply;
+class CPackJournalWriter;
 
 struct PlayerStatus
 {
@@ -79,6 +81,7 @@ class CGameHandler : public IGameCallback, CBattleInfoCallback
 {
 	CVCMIServer * lobby;
 	std::shared_ptr<CApplier<CBaseForGHApply>> applier;
+	std::unique_ptr<CPackJournalWriter> packJournal;
 public:
 	using FireShieldInfo = std::vector<std::pair<const CStack *, int64_t>>;
 	//use enums as parameters, because doMove(sth, true, false, true) is not readable
@@ -231,6 +234,9 @@ public:
 	bool arrangeStacks( ObjectInstanceID id1, ObjectInstanceID id2, ui8 what, SlotID p1, SlotID p2, si32 val, PlayerColor player);
 	void save(const std::string &fname);
 	void load(const std::string &fname);
+	void startRecordingPacks(const boost::filesystem::path & fname); //records game state and all packs sent to clients for vcmireplay
+
+	CPackMetrics packMetrics; //timings of received and sent packs, saved to VCMI_Server_metrics.json when game ends
 
 	void handleTimeEvents();
 	void handleTownEvents(CGTownInstance *town, NewTurn &n);
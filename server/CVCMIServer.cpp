@@ -243,6 +243,8 @@ void CVCMIServer::prepareToStartGame()
 
 	case StartInfo::NEW_GAME:
 		logNetwork->info("Preparing to start new game");
+		if(cmdLineOptions.count("seed"))
+			si->seedToBeUsed = cmdLineOptions["seed"].as<ui32>();
 		gh->init(si.get());
 		break;
 
@@ -262,6 +264,9 @@ void CVCMIServer::startGameImmidiately()
 	for(auto c : connections)
 		c->enterGameplayConnectionMode(gh->gs);
 
+	if(cmdLineOptions.count("record-packs"))
+		gh->startRecordingPacks(cmdLineOptions["record-packs"].as<std::string>());
+
 	state = EServerState::GAMEPLAY;
 }
 
@@ -382,6 +387,50 @@ void CVCMIServer::announceTxt(const std::string & txt, const std::string & playe
 	addToAnnounceQueue(std::move(cm));
 }
 
+void CVCMIServer::processConsoleCommand(const std::string & message)
+{
+	std::istringstream readed;
+	readed.str(message);
+	std::string cn; //command name
+	readed >> cn;
+
+	if(cn == "metrics")
+	{
+		std::string what;
+		readed >> what;
+
+		std::shared_ptr<CGameHandler> game;
+		{
+			//game handler is replaced under this lock when a game starts
+			boost::unique_lock<boost::mutex> stateLock(stateMutex);
+			game = gh;
+		}
+
+		if(!game)
+		{
+			logGlobal->warn("Pack metrics are available only during the game");
+		}
+		else if(what == "reset")
+		{
+			game->packMetrics.reset();
+		}
+		else if(what == "save")
+		{
+			std::string fname;
+			readed >> fname;
+			game->packMetrics.saveJson(fname.empty() ? "VCMI_Server_metrics.json" : fname);
+		}
+		else
+		{
+			console->print(game->packMetrics.toString());
+		}
+	}
+	else if(!cn.empty())
+	{
+		logGlobal->warn("Unknown command: %s. Available commands: metrics [reset|save <file>]", cn);
+	}
+}
+
 void CVCMIServer::addToAnnounceQueue(std::unique_ptr<CPackForLobby> pack)
 {
 	boost::unique_lock<boost::recursive_mutex> queueLock(mx);
@@ -856,7 +905,9 @@ static void handleCommandOptions(int argc, char * argv[], boost::program_options
 	("uuid", po::value<std::string>(), "")
 	("enable-shm-uuid", "use UUID for shared memory identifier")
 	("enable-shm", "enable usage of shared memory")
-	("port", po::value<ui16>(), "port at which server will listen to connections from client");
+	("port", po::value<ui16>(), "port at which server will listen to connections from client")
+	("record-packs", po::value<std::string>(), "record game state and all packs sent to clients into file that can be replayed by vcmireplay")
+	("seed", po::value<ui32>(), "random seed of new games, chosen by current time if not set");
 
 	if(argc > 1)
 	{
@@ -921,6 +972,17 @@ int main(int argc, char * argv[])
 		boost::asio::io_service io_service;
 		CVCMIServer server(opts);
 
+		//standard input is shared with client when it launched us
+		if(!opts.count("run-by-client"))
+		{
+			*console->cb = std::bind(&CVCMIServer::processConsoleCommand, &server, _1);
+			console->start();
+		}
+		auto consoleGuard = vstd::makeScopeGuard([]()
+		{
+			*console->cb = nullptr;
+		});
+
 		try
 		{
 			while(server.state != EServerState::SHUTDOWN)
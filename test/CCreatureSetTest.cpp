@@ -0,0 +1,61 @@
+/*
+ * CCreatureSetTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CCreatureSet.h"
+#include "../lib/CCreatureHandler.h"
+#include "../lib/VCMI_Lib.h"
+
+TEST(CCreatureSetTest, versionChangesWithStacks)
+{
+	CCreatureSet subject;
+
+	ui32 version = subject.getArmyVersion();
+
+	subject.putStack(SlotID(0), new CStackInstance(CreatureID(0), 10));
+	EXPECT_NE(version, subject.getArmyVersion());
+	version = subject.getArmyVersion();
+
+	subject.setStackCount(SlotID(0), 20);
+	EXPECT_NE(version, subject.getArmyVersion());
+	version = subject.getArmyVersion();
+
+	subject.setStackType(SlotID(0), CreatureID(1));
+	EXPECT_NE(version, subject.getArmyVersion());
+	version = subject.getArmyVersion();
+
+	subject.eraseStack(SlotID(0));
+	EXPECT_NE(version, subject.getArmyVersion());
+}
+
+TEST(CCreatureSetTest, cachedStrengthFollowsStacks)
+{
+	const ui64 firstValue = VLC->creh->creatures[0]->AIValue;
+	const ui64 secondValue = VLC->creh->creatures[1]->AIValue;
+
+	CCreatureSet subject;
+	EXPECT_EQ(subject.getArmyStrength(), 0u);
+
+	subject.putStack(SlotID(0), new CStackInstance(CreatureID(0), 10));
+	EXPECT_EQ(subject.getArmyStrength(), firstValue * 10);
+
+	const ui32 version = subject.getArmyVersion();
+	EXPECT_EQ(subject.getArmyStrength(), firstValue * 10);
+	EXPECT_EQ(version, subject.getArmyVersion());
+
+	subject.putStack(SlotID(1), new CStackInstance(CreatureID(1), 5));
+	EXPECT_EQ(subject.getArmyStrength(), firstValue * 10 + secondValue * 5);
+
+	subject.changeStackCount(SlotID(1), 5);
+	EXPECT_EQ(subject.getArmyStrength(), firstValue * 10 + secondValue * 10);
+
+	subject.eraseStack(SlotID(0));
+	EXPECT_EQ(subject.getArmyStrength(), secondValue * 10);
+}
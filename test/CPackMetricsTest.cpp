@@ -0,0 +1,64 @@
+/*
+ * CPackMetricsTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CPackMetrics.h"
+#include "../lib/NetPacks.h"
+#include "../lib/serializer/CTypeList.h"
+
+TEST(CDurationHistogramTest, percentiles)
+{
+	CDurationHistogram subject;
+	EXPECT_EQ(subject.getPercentile(0.5), 0);
+
+	for(int i = 0; i < 99; i++)
+		subject.add(10);
+	subject.add(5000);
+
+	EXPECT_EQ(subject.getCount(), 100);
+	EXPECT_EQ(subject.getTotal(), 99 * 10 + 5000);
+	EXPECT_EQ(subject.getMax(), 5000);
+	EXPECT_EQ(subject.getPercentile(0.5), 15);
+	EXPECT_EQ(subject.getPercentile(0.99), 15);
+	EXPECT_EQ(subject.getPercentile(1), 5000);
+}
+
+TEST(CPackMetricsTest, keyedByPackType)
+{
+	CPackMetrics subject;
+	EndTurn endTurn;
+	NewTurn newTurn;
+
+	subject.addReceived(&endTurn, 100, 20);
+	subject.addReceived(&endTurn, 300, 40);
+	subject.addSent(&newTurn, 64);
+	subject.addSent(&newTurn, 32);
+	subject.addApplied(&newTurn, 1000);
+
+	auto stats = subject.getStats();
+	ASSERT_EQ(stats.size(), 2);
+
+	const auto & endTurnStats = stats.at(typeList.getTypeID(&endTurn));
+	EXPECT_EQ(endTurnStats.received, 2);
+	EXPECT_EQ(endTurnStats.sent, 0);
+	EXPECT_EQ(endTurnStats.latency.getTotal(), 400);
+	EXPECT_EQ(endTurnStats.applyTime.getTotal(), 60);
+
+	const auto & newTurnStats = stats.at(typeList.getTypeID(&newTurn));
+	EXPECT_EQ(newTurnStats.sent, 2);
+	EXPECT_EQ(newTurnStats.bytesSent, 96);
+	EXPECT_EQ(newTurnStats.applyTime.getCount(), 1);
+
+	JsonNode json = subject.toJson();
+	EXPECT_EQ(json["packs"].Vector().size(), 2);
+
+	subject.reset();
+	EXPECT_TRUE(subject.getStats().empty());
+}
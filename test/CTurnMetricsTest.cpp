@@ -0,0 +1,53 @@
+/*
+ * CTurnMetricsTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/CTurnMetrics.h"
+
+TEST(CTurnMetricsTest, disabledByDefault)
+{
+	CTurnMetrics subject;
+
+	subject.startTurn(PlayerColor(0), 1);
+	subject.endTurn(PlayerColor(0));
+
+	EXPECT_FALSE(subject.isEnabled());
+	EXPECT_TRUE(subject.getTurns().empty());
+}
+
+TEST(CTurnMetricsTest, recordsTurnsOfPlayers)
+{
+	CTurnMetrics subject;
+	subject.enable();
+
+	subject.startTurn(PlayerColor(0), 1);
+	subject.addPathfinding(PlayerColor(0), CTurnMetrics::TClock::now());
+	subject.addPathfinding(PlayerColor(0), CTurnMetrics::TClock::now());
+	subject.addPathfinding(PlayerColor(1), CTurnMetrics::TClock::now()); //not in turn, ignored
+	subject.endTurn(PlayerColor(0));
+
+	subject.startTurn(PlayerColor(1), 1);
+	subject.endTurn(PlayerColor(1));
+	subject.endTurn(PlayerColor(1)); //already ended
+
+	auto turns = subject.getTurns();
+	ASSERT_EQ(turns.size(), 2u);
+
+	EXPECT_EQ(turns[0].player, PlayerColor(0));
+	EXPECT_EQ(turns[0].day, 1);
+	EXPECT_EQ(turns[0].pathfindingCount, 2u);
+	EXPECT_EQ(turns[1].player, PlayerColor(1));
+	EXPECT_EQ(turns[1].pathfindingCount, 0u);
+
+	JsonNode json = subject.toJson();
+	EXPECT_EQ(json["turns"].Vector().size(), 2u);
+	EXPECT_EQ(json["players"].Struct().size(), 2u);
+	EXPECT_EQ(json["players"][PlayerColor(0).getStr()]["turnTime"]["count"].Integer(), 1);
+}
@@ -14,6 +14,7 @@
 
 #include "../../lib/VCMIDirs.h"
 #include "../../lib/CGameState.h"
+#include "../../lib/CPlayerState.h"
 #include "../../lib/NetPacks.h"
 #include "../../lib/StartInfo.h"
 
@@ -21,6 +22,8 @@
 #include "../../lib/CStack.h"
 
 #include "../../lib/filesystem/ResourceID.h"
+#include "../../lib/serializer/CPackJournal.h"
+#include "../../lib/serializer/CTypeList.h"
 
 #include "../../lib/mapping/CMap.h"
 
@@ -331,3 +334,73 @@ TEST_F(CGameStateTest, battleResurrection)
 	EXPECT_EQ(unit->health.getCount(), 10);
 	EXPECT_EQ(unit->health.getResurrected(), 0);
 }
+
+TEST_F(CGameStateTest, stateHash)
+{
+	startTestGame();
+
+	const ui32 initialHash = gameState->calculateStateHash();
+	EXPECT_EQ(gameState->calculateStateHash(), initialHash);
+
+	CGHeroInstance * hero = map->heroesOnMap[0];
+
+	SetResources sr;
+	sr.player = hero->tempOwner;
+	sr.res = gameState->getPlayer(hero->tempOwner)->resources;
+	sr.res[Res::GOLD] += 1;
+	gameCallback->sendAndApply(&sr);
+
+	const ui32 resourcesHash = gameState->calculateStateHash();
+	EXPECT_NE(resourcesHash, initialHash);
+
+	SetMana sm;
+	sm.hid = hero->id;
+	sm.val = hero->mana + 1;
+	sm.absolute = true;
+	gameCallback->sendAndApply(&sm);
+
+	EXPECT_NE(gameState->calculateStateHash(), resourcesHash);
+}
+
+TEST_F(CGameStateTest, packJournalRoundTrip)
+{
+	startTestGame();
+
+	const boost::filesystem::path fileName = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-%%%%-%%%%.vpj");
+	CGHeroInstance * hero = map->heroesOnMap[0];
+
+	{
+		CPackJournalWriter writer(fileName, *gameCallback);
+
+		SetMana sm;
+		sm.hid = hero->id;
+		sm.val = hero->mana + 7;
+		sm.absolute = true;
+		writer.writePack(&sm);
+	}
+
+	GameCallbackMock replayCallback(this);
+	{
+		CPackJournalReader reader(fileName, replayCallback);
+		CGameState * replayState = replayCallback.gameState();
+		ASSERT_NE(replayState, nullptr);
+
+		CPack * pack = reader.readPack();
+		ASSERT_NE(pack, nullptr);
+		EXPECT_EQ(typeList.getTypeName(pack), "SetMana");
+
+		auto sm = dynamic_cast<SetMana *>(pack);
+		ASSERT_NE(sm, nullptr);
+		EXPECT_EQ(sm->hid, hero->id);
+		EXPECT_EQ(sm->val, hero->mana + 7);
+
+		replayState->apply(sm);
+		EXPECT_EQ(replayState->getHero(hero->id)->mana, hero->mana + 7);
+		delete pack;
+
+		EXPECT_EQ(reader.readPack(), nullptr);
+		delete replayState;
+	}
+
+	boost::filesystem::remove(fileName);
+}
@@ -167,3 +167,39 @@ TEST(MapManager, DrawTerrain_View)
 		throw;
 	}
 }
+
+TEST(MapManager, DrawTerrain_LargeSelectionMatchesSerialRepaint)
+{
+	// Selections of this size are matched in strips on several threads
+	auto drawMap = [](int threads)
+	{
+		auto map = make_unique<CMap>();
+		map->width = 108;
+		map->height = 108;
+		map->initTerrain();
+		auto editManager = map->getEditManager();
+		editManager->setThreadCount(threads);
+		CRandomGenerator gen;
+		gen.setSeed(42);
+		editManager->clearTerrain(&gen);
+
+		editManager->getTerrainSelection().selectRange(MapRect(int3(10, 10, 0), 60, 60));
+		editManager->drawTerrain(ETerrainType::GRASS, &gen);
+		editManager->getTerrainSelection().selectRange(MapRect(int3(30, 30, 0), 60, 40));
+		editManager->drawTerrain(ETerrainType::SAND, &gen);
+		return map;
+	};
+
+	const auto serial = drawMap(1);
+	const auto parallel = drawMap(4);
+	for(int y = 0; y < serial->height; ++y)
+	{
+		for(int x = 0; x < serial->width; ++x)
+		{
+			const int3 pos(x, y, 0);
+			EXPECT_EQ(parallel->getTile(pos).terType, serial->getTile(pos).terType);
+			EXPECT_EQ(parallel->getTile(pos).terView, serial->getTile(pos).terView);
+			EXPECT_EQ(parallel->getTile(pos).extTileFlags, serial->getTile(pos).extTileFlags);
+		}
+	}
+}
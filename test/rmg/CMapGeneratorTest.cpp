@@ -0,0 +1,111 @@
+/*
+ * CMapGeneratorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/mapping/CMap.h"
+#include "../../lib/mapping/CMapEditManager.h"
+#include "../../lib/rmg/CMapGenOptions.h"
+#include "../../lib/rmg/CMapGenerator.h"
+
+#include "../map/MapComparer.h"
+
+static std::unique_ptr<CMap> generateTestMap(int threads, int seed)
+{
+	CMapGenOptions opt;
+
+	opt.setHeight(CMapHeader::MAP_SIZE_MIDDLE);
+	opt.setWidth(CMapHeader::MAP_SIZE_MIDDLE);
+	opt.setHasTwoLevels(true);
+	opt.setPlayerCount(4);
+
+	opt.setPlayerTypeForStandardPlayer(PlayerColor(0), EPlayerType::HUMAN);
+	opt.setPlayerTypeForStandardPlayer(PlayerColor(1), EPlayerType::AI);
+	opt.setPlayerTypeForStandardPlayer(PlayerColor(2), EPlayerType::AI);
+	opt.setPlayerTypeForStandardPlayer(PlayerColor(3), EPlayerType::AI);
+
+	CMapGenerator gen;
+	gen.setThreadCount(threads);
+
+	auto map = gen.generate(&opt, seed);
+
+	std::vector<std::string> phases;
+	for(auto & phase : gen.getPhaseTimes())
+		phases.push_back(phase.first);
+	EXPECT_TRUE(vstd::contains(phases, "zone paths"));
+
+	return map;
+}
+
+TEST(CMapGeneratorTest, sameMapRegardlessOfThreadCount)
+{
+	const int seed = 4242;
+
+	std::unique_ptr<CMap> singleThreaded = generateTestMap(1, seed);
+	std::unique_ptr<CMap> multiThreaded = generateTestMap(4, seed);
+
+	MapComparer c;
+	c(multiThreaded, singleThreaded);
+}
+
+TEST(CMapGeneratorTest, benchmarkFixedSeed)
+{
+	const int seed = 31337;
+	const int runs = 3;
+
+	std::unique_ptr<CMap> reference;
+	for(int run = 0; run < runs; run++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::unique_ptr<CMap> map = generateTestMap(1, seed);
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		logGlobal->info("Generated map with seed %d in %d ms", seed, static_cast<int>(elapsed.count()));
+
+		if(reference)
+		{
+			MapComparer c;
+			c(map, reference);
+		}
+		else
+		{
+			reference = std::move(map);
+		}
+	}
+}
+
+TEST(CMapGeneratorTest, terrainViewTableMatchesValidation)
+{
+	static const int seeds[] = { 7, 1234, 987654 };
+
+	for(int seed : seeds)
+	{
+		std::unique_ptr<CMap> map = generateTestMap(1, seed);
+		auto mismatches = CTerrainViewPatternUtils::findTerrainViewTableMismatches(map.get());
+		EXPECT_TRUE(mismatches.empty()) << "seed " << seed << ", first mismatch at " << (mismatches.empty() ? int3() : mismatches.front()).toString();
+	}
+}
+
+TEST(CMapGeneratorTest, incrementalGuardsMatchFullCalculation)
+{
+	std::unique_ptr<CMap> map = generateTestMap(1, 555);
+
+	for(int z = 0; z < (map->twoLevel ? 2 : 1); z++)
+	{
+		for(int y = 0; y < map->height; y++)
+		{
+			for(int x = 0; x < map->width; x++)
+			{
+				const int3 pos(x, y, z);
+				const int3 guard = map->guardingCreaturePosition(pos);
+				EXPECT_EQ(map->guardingCreaturePositions[x][y][z], guard) << pos.toString();
+				EXPECT_EQ(map->isTileGuarded(pos), guard.valid()) << pos.toString();
+			}
+		}
+	}
+}
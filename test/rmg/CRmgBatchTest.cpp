@@ -0,0 +1,95 @@
+/*
+ * CRmgBatchTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../mapgen/CRmgBatch.h"
+#include "../../lib/mapping/CMap.h"
+#include "../../lib/rmg/CRmgTemplate.h"
+
+static CMapGenOptions makeBatchOptions()
+{
+	CMapGenOptions opt;
+
+	opt.setHeight(CMapHeader::MAP_SIZE_SMALL);
+	opt.setWidth(CMapHeader::MAP_SIZE_SMALL);
+	opt.setHasTwoLevels(false);
+	opt.setPlayerCount(2);
+
+	opt.setPlayerTypeForStandardPlayer(PlayerColor(0), EPlayerType::HUMAN);
+	opt.setPlayerTypeForStandardPlayer(PlayerColor(1), EPlayerType::AI);
+
+	return opt;
+}
+
+static void compareResults(const CRmgBatch::MapResult & actual, const CRmgBatch::MapResult & expected)
+{
+	EXPECT_EQ(actual.seed, expected.seed);
+	EXPECT_TRUE(actual.success) << actual.error;
+	EXPECT_EQ(actual.templateName, expected.templateName);
+	EXPECT_EQ(actual.objects, expected.objects);
+	EXPECT_EQ(actual.towns, expected.towns);
+	EXPECT_EQ(actual.mines, expected.mines);
+	EXPECT_EQ(actual.monsters, expected.monsters);
+	EXPECT_EQ(actual.reachableTowns, expected.reachableTowns);
+}
+
+TEST(CRmgBatchTest, sameSeedsGiveSameMaps)
+{
+	const int firstSeed = 100;
+	const int count = 2;
+
+	CRmgBatch parallel(makeBatchOptions(), "");
+	parallel.setDryRun(true);
+	parallel.setThreadCount(count);
+	parallel.run(firstSeed, count);
+
+	CRmgBatch sequential(makeBatchOptions(), "");
+	sequential.setDryRun(true);
+	sequential.setThreadCount(1);
+	sequential.run(firstSeed, count);
+
+	ASSERT_EQ(parallel.getResults().size(), static_cast<size_t>(count));
+	ASSERT_EQ(sequential.getResults().size(), static_cast<size_t>(count));
+
+	for(int i = 0; i < count; i++)
+	{
+		const CRmgBatch::MapResult & expected = sequential.getResults()[i];
+		EXPECT_TRUE(expected.success) << expected.error;
+		EXPECT_EQ(expected.seed, firstSeed + i);
+		EXPECT_TRUE(expected.fileName.empty());
+		compareResults(parallel.getResults()[i], expected);
+	}
+}
+
+TEST(CRmgBatchTest, selectedTemplateIsUsed)
+{
+	CRmgBatch randomTemplate(makeBatchOptions(), "");
+	randomTemplate.setDryRun(true);
+	randomTemplate.run(7, 1);
+
+	const CRmgBatch::MapResult & expected = randomTemplate.getResults().front();
+	ASSERT_TRUE(expected.success) << expected.error;
+
+	CMapGenOptions options = makeBatchOptions();
+	for(auto & entry : options.getAvailableTemplates())
+	{
+		if(entry.second->getName() == expected.templateName)
+			options.setMapTemplate(entry.second);
+	}
+	ASSERT_NE(options.getMapTemplate(), nullptr);
+	EXPECT_TRUE(options.checkOptions());
+
+	CRmgBatch selectedTemplate(options, "");
+	selectedTemplate.setDryRun(true);
+	selectedTemplate.run(7, 1);
+
+	EXPECT_EQ(selectedTemplate.getResults().front().templateName, expected.templateName);
+	EXPECT_TRUE(selectedTemplate.getResults().front().success);
+}
@@ -0,0 +1,129 @@
+/*
+ * CTileSetTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/rmg/CTileSet.h"
+#include "../../lib/CRandomGenerator.h"
+
+//map generator output depends on iteration order, so it must match std::set exactly
+TEST(CTileSetTest, sameAsStdSet)
+{
+	const int3 mapSize(36, 24, 2);
+	CRandomGenerator rand;
+	rand.setSeed(1337);
+
+	CTileSet subject(mapSize);
+	std::set<int3> expected;
+
+	for(int i = 0; i < 5000; i++)
+	{
+		int3 tile(rand.nextInt(mapSize.x - 1), rand.nextInt(mapSize.y - 1), rand.nextInt(mapSize.z - 1));
+
+		switch(rand.nextInt(2))
+		{
+		case 0:
+		case 1:
+			EXPECT_EQ(subject.insert(tile), expected.insert(tile).second);
+			break;
+		case 2:
+			EXPECT_EQ(subject.erase(tile), expected.erase(tile) == 1);
+			break;
+		}
+
+		EXPECT_EQ(subject.contains(tile), vstd::contains(expected, tile));
+		ASSERT_EQ(subject.size(), expected.size());
+
+		if(i % 100 == 0)
+		{
+			std::vector<int3> actualTiles(subject.begin(), subject.end());
+			std::vector<int3> expectedTiles(expected.begin(), expected.end());
+			ASSERT_EQ(actualTiles, expectedTiles);
+		}
+	}
+
+	subject.eraseIf([](const int3 & tile)
+	{
+		return tile.x % 2 == 0;
+	});
+	vstd::erase_if(expected, [](const int3 & tile)
+	{
+		return tile.x % 2 == 0;
+	});
+
+	std::vector<int3> actualTiles(subject.begin(), subject.end());
+	std::vector<int3> expectedTiles(expected.begin(), expected.end());
+	EXPECT_EQ(actualTiles, expectedTiles);
+
+	subject.clear();
+	EXPECT_TRUE(subject.empty());
+	EXPECT_EQ(subject.begin(), subject.end());
+}
+
+TEST(CTileSearchBufferTest, resetForgetsTiles)
+{
+	CTileSearchBuffer subject;
+	subject.resize(int3(10, 10, 1));
+
+	const int3 tile(3, 4, 0);
+	const int3 from(3, 3, 0);
+
+	EXPECT_FALSE(subject.hasDistance(tile));
+	EXPECT_FALSE(subject.getCameFrom(tile).valid());
+
+	subject.setDistance(tile, 2.5f);
+	subject.setCameFrom(tile, from);
+	subject.close(tile);
+	subject.close(tile);
+
+	EXPECT_TRUE(subject.hasDistance(tile));
+	EXPECT_EQ(subject.getDistance(tile), 2.5f);
+	EXPECT_EQ(subject.getCameFrom(tile), from);
+	EXPECT_TRUE(subject.isClosed(tile));
+	EXPECT_EQ(subject.getClosed().size(), 1);
+
+	subject.reset();
+
+	EXPECT_FALSE(subject.hasDistance(tile));
+	EXPECT_FALSE(subject.getCameFrom(tile).valid());
+	EXPECT_FALSE(subject.isClosed(tile));
+	EXPECT_TRUE(subject.getClosed().empty());
+}
+
+TEST(CTileBucketsTest, sameAsLinearScan)
+{
+	const int3 mapSize(72, 50, 1);
+	CRandomGenerator rand;
+	rand.setSeed(4004);
+
+	CTileBuckets subject(mapSize, 10);
+	std::vector<int3> tiles;
+
+	for(int i = 0; i < 300; i++)
+	{
+		int3 tile(rand.nextInt(mapSize.x - 1), rand.nextInt(mapSize.y - 1), 0);
+
+		for(ui32 distance : {0, 1, 50, 100, 101, 400})
+		{
+			bool expected = false;
+			for(auto & other : tiles)
+			{
+				if(tile.dist2dSQ(other) <= distance)
+					expected = true;
+			}
+			EXPECT_EQ(subject.hasTileWithin(tile, distance), expected);
+		}
+
+		if(i % 3 == 0)
+		{
+			subject.insert(tile);
+			tiles.push_back(tile);
+		}
+	}
+}
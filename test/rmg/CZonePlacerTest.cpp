@@ -0,0 +1,63 @@
+/*
+ * CZonePlacerTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/rmg/CZonePlacer.h"
+
+static const float MAP_SIZE = 72;
+
+TEST(CZoneLayoutTest, connectedZonesAttract)
+{
+	CZoneLayout layout(MAP_SIZE, 4e-3, 4e-3);
+	int a = layout.addZone(float3(0.2f, 0.5f, 0), 8);
+	int b = layout.addZone(float3(0.8f, 0.5f, 0), 8);
+	layout.addConnection(a, b);
+	layout.addConnection(b, a);
+
+	const float initialDistance = layout.getCenter(a).dist2d(layout.getCenter(b));
+	layout.attractConnectedZones();
+	layout.applyForces();
+
+	EXPECT_LT(layout.getCenter(a).dist2d(layout.getCenter(b)), initialDistance);
+	EXPECT_GT(layout.getTotalDistance(), 0);
+}
+
+TEST(CZoneLayoutTest, overlappingZonesSeparate)
+{
+	CZoneLayout layout(MAP_SIZE, 4e-3, 4e-3);
+	int a = layout.addZone(float3(0.48f, 0.5f, 0), 10);
+	int b = layout.addZone(float3(0.52f, 0.5f, 0), 10);
+	int c = layout.addZone(float3(0.5f, 0.5f, 1), 10); //other level, does not interact
+
+	const float initialDistance = layout.getCenter(a).dist2d(layout.getCenter(b));
+	layout.separateOverlappingZones();
+	EXPECT_GT(layout.getTotalOverlap(), 0);
+	layout.applyForces();
+
+	EXPECT_GT(layout.getCenter(a).dist2d(layout.getCenter(b)), initialDistance);
+	EXPECT_EQ(layout.getCenter(c).x, 0.5f);
+	EXPECT_EQ(layout.getCenter(c).y, 0.5f);
+}
+
+TEST(CZoneLayoutTest, stopsWhenAtRest)
+{
+	CZoneLayout layout(MAP_SIZE, 4e-3, 4e-3);
+	layout.addZone(float3(0.3f, 0.3f, 0), 12);
+	int b = layout.addZone(float3(0.7f, 0.7f, 0), 12);
+	layout.addZone(float3(0.3f, 0.3f, 1), 12); //zones on different levels can overlap
+
+	EXPECT_EQ(layout.iterate(), 0);
+	EXPECT_EQ(layout.getTotalDistance(), 0);
+	EXPECT_EQ(layout.getTotalOverlap(), 0);
+	EXPECT_FALSE(layout.moveOneZone());
+
+	EXPECT_EQ(layout.getCenter(b).x, 0.7f);
+	EXPECT_EQ(layout.getCenter(b).y, 0.7f);
+}
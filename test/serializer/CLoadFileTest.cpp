@@ -0,0 +1,73 @@
+/*
+ * CLoadFileTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/serializer/BinarySerializer.h"
+#include "../../lib/serializer/BinaryDeserializer.h"
+#include "../../lib/CStopWatch.h"
+
+class CLoadFileTest : public ::testing::Test
+{
+public:
+	boost::filesystem::path fileName;
+
+	CLoadFileTest()
+		: fileName(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-%%%%-%%%%.vsav"))
+	{
+	}
+
+	virtual ~CLoadFileTest()
+	{
+		boost::filesystem::remove(fileName);
+	}
+};
+
+TEST_F(CLoadFileTest, loadsDataSpanningSeveralPrefetchChunks)
+{
+	std::vector<si32> numbers;
+	std::vector<std::string> strings;
+	for(si32 i = 0; i < 1000000; i++)
+		numbers.push_back(i * 7);
+	for(si32 i = 0; i < 10000; i++)
+		strings.push_back(std::string(i % 300, 'a' + i % 26));
+
+	{
+		CSaveFile save(fileName);
+		save << numbers << strings;
+	}
+
+	std::vector<si32> loadedNumbers;
+	std::vector<std::string> loadedStrings;
+
+	CStopWatch timer;
+	{
+		CLoadFile load(fileName);
+		load >> loadedNumbers >> loadedStrings;
+		EXPECT_EQ(load.getReadPosition(), boost::filesystem::file_size(fileName));
+	}
+	logGlobal->info("Loaded %d bytes in %d ms", boost::filesystem::file_size(fileName), timer.getDiff());
+
+	EXPECT_EQ(loadedNumbers, numbers);
+	EXPECT_EQ(loadedStrings, strings);
+}
+
+TEST_F(CLoadFileTest, throwsOnTruncatedFile)
+{
+	{
+		CSaveFile save(fileName);
+		save << ui32(42);
+	}
+
+	CLoadFile load(fileName);
+	ui32 value = 0;
+	load >> value;
+	EXPECT_EQ(value, 42);
+	EXPECT_THROW(load >> value, std::runtime_error);
+}
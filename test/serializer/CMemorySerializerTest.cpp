@@ -0,0 +1,116 @@
+/*
+ * CMemorySerializerTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/serializer/CMemorySerializer.h"
+#include "../../lib/CStopWatch.h"
+
+TEST(CMemorySerializerTest, primitiveVectorRoundTrip)
+{
+	CMemorySerializer subject;
+
+	std::vector<ui16> shorts = {1, 2, 0xABCD};
+	std::vector<si64> longs = {-1, 0, 1LL << 40};
+	std::vector<double> doubles = {0.5, -3.25};
+	std::vector<bool> flags = {true, false, true};
+	std::vector<ui8> empty;
+
+	subject.oser & shorts & longs & doubles & flags & empty;
+
+	std::vector<ui16> loadedShorts;
+	std::vector<si64> loadedLongs;
+	std::vector<double> loadedDoubles;
+	std::vector<bool> loadedFlags(flags.size());
+	std::vector<ui8> loadedEmpty = {42};
+
+	subject.iser & loadedShorts & loadedLongs & loadedDoubles & loadedFlags & loadedEmpty;
+
+	EXPECT_EQ(loadedShorts, shorts);
+	EXPECT_EQ(loadedLongs, longs);
+	EXPECT_EQ(loadedDoubles, doubles);
+	EXPECT_EQ(loadedFlags, flags);
+	EXPECT_TRUE(loadedEmpty.empty());
+}
+
+TEST(CMemorySerializerTest, primitiveVectorLayoutMatchesElementWise)
+{
+	CMemorySerializer subject;
+
+	std::vector<si32> values = {7, -8, 9};
+	subject.oser & values;
+
+	ui32 length = 0;
+	subject.iser & length;
+	ASSERT_EQ(length, values.size());
+
+	for(si32 expected : values)
+	{
+		si32 actual = 0;
+		subject.iser & actual;
+		EXPECT_EQ(actual, expected);
+	}
+}
+
+TEST(CMemorySerializerTest, primitiveVectorReversesEndianess)
+{
+	std::vector<ui16> values = {0x1234, 0xABCD};
+
+	//length is reversed too, so write it in foreign byte order
+	CMemorySerializer foreign;
+	ui32 length = 0x02000000;
+	foreign.oser & length;
+	foreign.oser.write(&values[0], sizeof(ui16) * values.size());
+	foreign.iser.reverseEndianess = true;
+
+	std::vector<ui16> loaded;
+	foreign.iser & loaded;
+
+	ASSERT_EQ(loaded.size(), 2);
+	EXPECT_EQ(loaded[0], 0x3412);
+	EXPECT_EQ(loaded[1], 0xCDAB);
+}
+
+TEST(CMemorySerializerTest, fogOfWarSizedGrid)
+{
+	const int width = 252, height = 252, levels = 2;
+
+	std::vector<std::vector<std::vector<ui8>>> grid(width, std::vector<std::vector<ui8>>(height, std::vector<ui8>(levels, 0)));
+	for(int x = 0; x < width; x++)
+		for(int y = 0; y < height; y++)
+			grid[x][y][(x + y) % levels] = 1;
+
+	CStopWatch timer;
+	CMemorySerializer subject;
+	subject.oser & grid;
+	auto saveTime = timer.getDiff();
+
+	std::vector<std::vector<std::vector<ui8>>> loaded;
+	subject.iser & loaded;
+	auto loadTime = timer.getDiff();
+
+	logGlobal->info("%dx%dx%d grid: saved in %d ms, loaded in %d ms", width, height, levels, saveTime, loadTime);
+
+	EXPECT_EQ(loaded, grid);
+}
+
+TEST(CMemorySerializerTest, multiArrayOfStructsRoundTrip)
+{
+	boost::multi_array<int3, 3> positions(boost::extents[3][2][1]);
+	positions[0][1][0] = int3(1, 2, 0);
+	positions[2][0][0] = int3(-1, -1, -1);
+
+	CMemorySerializer subject;
+	subject.oser & positions;
+
+	boost::multi_array<int3, 3> loaded;
+	subject.iser & loaded;
+
+	EXPECT_EQ(loaded, positions);
+}
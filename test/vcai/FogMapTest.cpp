@@ -0,0 +1,194 @@
+/*
+* FogMapTest.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+
+#include "StdInc.h"
+#include "gtest/gtest.h"
+
+#include "../AI/VCAI/FogMap.h"
+
+class FogMapFixture : public FogMap
+{
+public:
+	int3 size;
+	FoW fow;
+
+	FogMapFixture(const int3 & size)
+		: size(size), fow(boost::extents[size.x][size.y][size.z])
+	{
+		//irregular visible area on every level, so frontier has tiles in all directions
+		for(int x = 0; x < size.x; x++)
+		{
+			for(int y = 0; y < size.y; y++)
+			{
+				for(int z = 0; z < size.z; z++)
+					fow[x][y][z] = ((x * 7 + y * 3 + z * 5) % 11) < 6 || (x < 4 && y < 4);
+			}
+		}
+	}
+
+protected:
+	const FoW & getFoW() const override
+	{
+		return fow;
+	}
+
+	int3 getMapSize() const override
+	{
+		return size;
+	}
+};
+
+class FogMapTest : public ::testing::Test
+{
+public:
+	FogMapFixture subject;
+
+	FogMapTest()
+		: subject(int3(13, 9, 2))
+	{
+	}
+
+	bool isInTheMap(const int3 & tile) const
+	{
+		return tile.x >= 0 && tile.y >= 0 && tile.z >= 0
+			&& tile.x < subject.size.x && tile.y < subject.size.y && tile.z < subject.size.z;
+	}
+
+	/// Perimeter of visible area in order of the full map scan exploration used before
+	std::vector<int3> scanFrontier() const
+	{
+		std::vector<int3> result;
+
+		for(int x = 0; x < subject.size.x; x++)
+		{
+			for(int y = 0; y < subject.size.y; y++)
+			{
+				for(int z = 0; z < subject.size.z; z++)
+				{
+					int3 tile(x, y, z);
+
+					if(!subject.fow[x][y][z])
+						continue;
+
+					for(const int3 & dir : int3::getDirs())
+					{
+						int3 neighbour = tile + dir;
+
+						if(isInTheMap(neighbour) && !subject.fow[neighbour.x][neighbour.y][neighbour.z])
+						{
+							result.push_back(tile);
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+	/// Hidden tiles counted one by one like exploration did before
+	int scanHiddenTilesInSight(const int3 & pos, int radius) const
+	{
+		int result = 0;
+
+		for(int x = pos.x - radius; x <= pos.x + radius; x++)
+		{
+			for(int y = pos.y - radius; y <= pos.y + radius; y++)
+			{
+				int3 tile(x, y, pos.z);
+
+				if(isInTheMap(tile) && pos.dist2d(tile) - 0.5 < radius && !subject.fow[x][y][pos.z])
+					result++;
+			}
+		}
+
+		return result;
+	}
+
+	void checkAgainstScan()
+	{
+		EXPECT_EQ(subject.getFrontier(), scanFrontier());
+
+		for(int x = 0; x < subject.size.x; x++)
+		{
+			for(int y = 0; y < subject.size.y; y++)
+			{
+				for(int z = 0; z < subject.size.z; z++)
+				{
+					int3 tile(x, y, z);
+
+					for(int radius : {1, 2, 5})
+						EXPECT_EQ(subject.countHiddenTilesInSight(tile, radius), scanHiddenTilesInSight(tile, radius)) << tile.toString() << " radius " << radius;
+				}
+			}
+		}
+	}
+};
+
+TEST_F(FogMapTest, matchesFullMapScan)
+{
+	checkAgainstScan();
+}
+
+TEST_F(FogMapTest, updateRevealedTiles)
+{
+	checkAgainstScan();
+
+	std::unordered_set<int3, ShashInt3> revealed;
+
+	for(int x = 5; x < 10; x++)
+	{
+		for(int y = 2; y < 6; y++)
+		{
+			subject.fow[x][y][1] = 1;
+			revealed.insert(int3(x, y, 1));
+		}
+	}
+
+	subject.update(revealed);
+	checkAgainstScan();
+}
+
+TEST_F(FogMapTest, updateHiddenTiles)
+{
+	checkAgainstScan();
+
+	std::unordered_set<int3, ShashInt3> hidden;
+
+	for(int x = 0; x < 3; x++)
+	{
+		for(int y = 0; y < 3; y++)
+		{
+			subject.fow[x][y][0] = 0;
+			hidden.insert(int3(x, y, 0));
+		}
+	}
+	subject.fow[12][8][1] = 0;
+	hidden.insert(int3(12, 8, 1));
+
+	subject.update(hidden);
+	checkAgainstScan();
+}
+
+TEST_F(FogMapTest, squareCountsAllHiddenTiles)
+{
+	const int3 center(6, 4, 0);
+	int expected = 0;
+
+	for(int x = 4; x <= 8; x++)
+	{
+		for(int y = 2; y <= 6; y++)
+			expected += !subject.fow[x][y][0];
+	}
+
+	EXPECT_EQ(subject.countHiddenTilesInSquare(center, 2), expected);
+	EXPECT_EQ(subject.countHiddenTilesInSquare(int3(0, 0, 1), 0), !subject.fow[0][0][1]);
+}
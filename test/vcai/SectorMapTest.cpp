@@ -0,0 +1,164 @@
+/*
+* SectorMapTest.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+
+#include "StdInc.h"
+#include "gtest/gtest.h"
+
+#include "../AI/VCAI/SectorMap.h"
+#include "../../lib/mapping/CMap.h"
+#include "../../lib/mapObjects/CObjectHandler.h"
+
+class SectorMapFixture : public SectorMap
+{
+public:
+	int3 size;
+	std::vector<TerrainTile> tiles;
+	std::vector<bool> visible;
+	std::set<ObjectInstanceID> objectsOnMap;
+
+	SectorMapFixture(const int3 & size)
+		: size(size), tiles(size.x * size.y * size.z), visible(tiles.size(), true)
+	{
+		for(auto & tile : tiles)
+			tile.terType = ETerrainType::GRASS;
+	}
+
+	TerrainTile & tile(const int3 & pos)
+	{
+		return tiles[index(pos)];
+	}
+
+	void setVisible(const int3 & pos, bool isVisible)
+	{
+		visible[index(pos)] = isVisible;
+	}
+
+	void setBlocked(const int3 & pos, bool blocked)
+	{
+		tile(pos).blocked = blocked;
+	}
+
+protected:
+	int3 getMapSize() const override
+	{
+		return size;
+	}
+
+	const TerrainTile * getTile(const int3 & pos) const override
+	{
+		return visible[index(pos)] ? &tiles[index(pos)] : nullptr;
+	}
+
+	bool isObjectOnTheMap(ObjectInstanceID id) const override
+	{
+		return vstd::contains(objectsOnMap, id);
+	}
+
+private:
+	size_t index(const int3 & pos) const
+	{
+		return (pos.z * size.y + pos.y) * size.x + pos.x;
+	}
+};
+
+TEST(SectorMapTest, mergesSectorsOfRevealedTiles)
+{
+	SectorMapFixture subject(int3(7, 3, 1));
+
+	for(int y = 0; y < 3; y++)
+		subject.setVisible(int3(3, y, 0), false);
+
+	EXPECT_NE(subject.getSector(int3(0, 1, 0)), SectorMap::NOT_AVAILABLE);
+	EXPECT_EQ(subject.getSector(int3(3, 1, 0)), SectorMap::NOT_AVAILABLE);
+	EXPECT_TRUE(subject.isSameSector(int3(0, 0, 0), int3(2, 2, 0)));
+	EXPECT_FALSE(subject.isSameSector(int3(0, 1, 0), int3(6, 1, 0)));
+
+	subject.setVisible(int3(3, 1, 0), true);
+	subject.update({int3(3, 1, 0)});
+
+	EXPECT_TRUE(subject.isSameSector(int3(0, 1, 0), int3(6, 1, 0)));
+	EXPECT_TRUE(subject.isSameSector(int3(3, 1, 0), int3(6, 0, 0)));
+	EXPECT_EQ(subject.getSector(int3(3, 0, 0)), SectorMap::NOT_AVAILABLE);
+}
+
+TEST(SectorMapTest, rebuildsSectorsWhenTileIsBlocked)
+{
+	SectorMapFixture subject(int3(7, 3, 1));
+
+	EXPECT_TRUE(subject.isSameSector(int3(0, 1, 0), int3(6, 1, 0)));
+
+	std::unordered_set<int3, ShashInt3> column;
+	for(int y = 0; y < 3; y++)
+	{
+		subject.setBlocked(int3(3, y, 0), true);
+		column.insert(int3(3, y, 0));
+	}
+	subject.update(column);
+
+	EXPECT_FALSE(subject.isSameSector(int3(0, 1, 0), int3(6, 1, 0)));
+	EXPECT_TRUE(subject.isSameSector(int3(0, 0, 0), int3(2, 2, 0)));
+	EXPECT_TRUE(subject.isSameSector(int3(4, 0, 0), int3(6, 2, 0)));
+	EXPECT_EQ(subject.getSector(int3(3, 1, 0)), SectorMap::NOT_AVAILABLE);
+}
+
+TEST(SectorMapTest, findsNearestEmbarkmentPoint)
+{
+	SectorMapFixture subject(int3(8, 9, 2));
+
+	//land in the west of the lower level, upper level is land only
+	for(int x = 4; x < 8; x++)
+	{
+		for(int y = 0; y < 9; y++)
+			subject.tile(int3(x, y, 0)).terType = ETerrainType::WATER;
+	}
+
+	EXPECT_FALSE(subject.isSameSector(int3(3, 4, 0), int3(4, 4, 0)));
+
+	const int3 fromLand = subject.getNearestEmbarkmentPoint(int3(0, 0, 0));
+	EXPECT_EQ(fromLand.x, 4);
+	EXPECT_EQ(fromLand.z, 0);
+	EXPECT_EQ(int3(0, 0, 0).chebdist2d(fromLand), 4);
+
+	const int3 fromWater = subject.getNearestEmbarkmentPoint(int3(7, 8, 0));
+	EXPECT_EQ(fromWater.x, 3);
+	EXPECT_EQ(fromWater.z, 0);
+	EXPECT_EQ(int3(7, 8, 0).chebdist2d(fromWater), 4);
+
+	EXPECT_EQ(subject.getNearestEmbarkmentPoint(int3(3, 3, 0)).x, 4);
+	EXPECT_EQ(subject.getNearestEmbarkmentPoint(int3(1, 1, 1)), int3(-1, -1, -1));
+}
+
+TEST(SectorMapTest, checksTilesOfRemovedObjectWhenItIsGone)
+{
+	SectorMapFixture subject(int3(7, 3, 1));
+
+	CGObjectInstance obj;
+	obj.id = ObjectInstanceID(5);
+	obj.pos = int3(3, 2, 0);
+	obj.appearance.setSize(1, 3);
+
+	for(int y = 0; y < 3; y++)
+		subject.setBlocked(int3(3, y, 0), true);
+	subject.objectsOnMap.insert(obj.id);
+
+	EXPECT_FALSE(subject.isSameSector(int3(0, 1, 0), int3(6, 1, 0)));
+
+	subject.objectRemoved(&obj);
+
+	//removal is announced before the object leaves the map
+	EXPECT_FALSE(subject.isSameSector(int3(0, 1, 0), int3(6, 1, 0)));
+
+	for(int y = 0; y < 3; y++)
+		subject.setBlocked(int3(3, y, 0), false);
+	subject.objectsOnMap.erase(obj.id);
+
+	EXPECT_TRUE(subject.isSameSector(int3(0, 1, 0), int3(6, 1, 0)));
+	EXPECT_NE(subject.getSector(int3(3, 0, 0)), SectorMap::NOT_AVAILABLE);
+}